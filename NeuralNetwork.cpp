@@ -1,496 +1,3153 @@
 #include "NeuralNetwork.h"
-#include "ImageUtils.h"
+#include "NeuralNetworkPreProcessing.h"
+#include "NeuralNetworkStats.h"
 #include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Hash/CityHash.h"
+#include "UObject/StrongObjectPtr.h"
 
 
-ANeuralNetwork::ANeuralNetwork()
+namespace
 {
-    // Set this actor to call Tick() every frame. You can turn this off to improve performance if you don't need it.
-    PrimaryActorTick.bCanEverTick = true;
-}
+    const TCHAR* CPURuntimeName = TEXT("NNERuntimeORTCpu");
 
-
-// Asynchronously loads model data and calls OnModelDataLoaded when complete.
-void ANeuralNetwork::LoadModelDataAsync()
-{
-    if (LazyLoadedModelData.IsNull())
+    // Shares the model through the registry when there is one, otherwise creates a private copy
+    FSharedModelCPU CreateModel(UNeuralNetworkModelRegistry* Registry, INNERuntimeCPU& Runtime, UNNEModelData* ModelData)
     {
-        UE_LOG(LogTemp, Error, TEXT("LazyLoadedModelData is not set, please assign it in the editor"));
+        if (Registry)
+        {
+            return Registry->FindOrCreateModel(Runtime, CPURuntimeName, ModelData);
+        }
+        return FSharedModelCPU(Runtime.CreateModel(ModelData).Release());
     }
-    else
+
+    // Returns a claimed instance to the pool and wakes anyone blocked on a free instance
+    void ReleaseModelHelper(FModelHelper& ModelHelper, FEventRef& InstanceFreed)
     {
-        // Async Load Model Data and call OnModelDataLoaded when complete
-        UAssetManager::GetStreamableManager().RequestAsyncLoad(LazyLoadedModelData.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ANeuralNetwork::OnModelDataLoaded));
+        ModelHelper.bIsRunning = false;
+        InstanceFreed->Trigger();
     }
-}
 
-
-// Create Model and set the Model Helper
-bool ANeuralNetwork::CreateCPUModel()
-{
-    bool bSuccess = false;
-
-      // Check that model data is loaded and valid
-    if (LazyLoadedModelData.IsValid())
+    // Splits a rank 4 [N, C, H, W] or rank 5 [N, Frame, C, H, W] shape into its named dimensions
+    void GetImageDims(TConstArrayView<int32> Dims, int32& Rank, int32& Dimension, int32& Frame, int32& ColorChannels, int32& Height, int32& Width)
     {
-        // Log the name of the loaded model
-        UE_LOG(LogTemp, Display, TEXT("LazyLoadedModelData loaded %s"), *LazyLoadedModelData.Get()->GetName());
+        Rank = Dims.Num();
+        Dimension = Rank > 0 ? Dims[0] : 0;
+        Frame = 0;
 
-        // Create NNE Runtime
-        TWeakInterfacePtr<INNERuntimeCPU> Runtime = UE::NNE::GetRuntime<INNERuntimeCPU>(FString("NNERuntimeORTCpu"));
-        if (Runtime.IsValid())
+        if (Rank == 4)
         {
-            // Initialize ModelHelper and create the model instance
-            m_ModelHelper = MakeShared<FModelHelper>();
-            Model = Runtime->CreateModel(LazyLoadedModelData.Get());
+            ColorChannels = Dims[1];
+            Height = Dims[2];
+            Width = Dims[3];
+        }
+        if (Rank == 5)
+        {
+            Frame = Dims[1];
+            ColorChannels = Dims[2];
+            Height = Dims[3];
+            Width = Dims[4];
+        }
+    }
 
-            if (Model.IsValid())
-            {
-                m_mutex.Lock();
+    // Builds a rank 4 or rank 5 image shape, empty for any other rank
+    TArray<uint32> MakeImageShape(int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width)
+    {
+        TArray<uint32> ShapeData;
 
-                m_ModelHelper->ModelInstance = Model->CreateModelInstance();
+        if (Rank == 4)
+        {
+            ShapeData = { (uint32)Dimension, (uint32)ColorChannels, (uint32)Height, (uint32)Width };
+        }
+        if (Rank == 5)
+        {
+            ShapeData = { (uint32)Dimension, (uint32)Frame, (uint32)ColorChannels, (uint32)Height, (uint32)Width };
+        }
 
-                m_mutex.Unlock();
+        return ShapeData;
+    }
 
-                if (m_ModelHelper->ModelInstance.IsValid())
-                {
-                    // Model creation successful
-                    m_mutex.Lock();
-                    m_ModelHelper->bIsRunning = false;
-                    m_mutex.Unlock();
+    // Fills in output dimensions the runtime left open, a leading variable dimension follows the input batch size
+    bool ResolveOutputShape(const UE::NNE::FSymbolicTensorShape& SymbolicShape, uint32 BatchSize, UE::NNE::FTensorShape& OutShape)
+    {
+        TArray<uint32> ShapeData;
 
-                    IsModelRunning = false;
-                    bSuccess = true;
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Display, TEXT("Failed to create Model Instance"));
-                }
+        TConstArrayView<int32> SymbolicDims = SymbolicShape.GetData();
+        for (int32 DimIdx = 0; DimIdx < SymbolicDims.Num(); ++DimIdx)
+        {
+            if (SymbolicDims[DimIdx] >= 0)
+            {
+                ShapeData.Add(SymbolicDims[DimIdx]);
+            }
+            else if (DimIdx == 0)
+            {
+                ShapeData.Add(BatchSize);
             }
             else
             {
-                UE_LOG(LogTemp, Display, TEXT("Failed to create Model"));
+                return false;
             }
         }
-        else
+
+        OutShape = UE::NNE::FTensorShape::Make(ShapeData);
+        return true;
+    }
+
+    // Preprocesses straight into Num elements of DataType at Data, false for types the kernels cannot write
+    bool PixelsToTypedTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, void* Data, ENNETensorDataType DataType, int32 Num)
+    {
+        switch (DataType)
         {
-            UE_LOG(LogTemp, Display, TEXT("Failed to create Runtime"));
+        case ENNETensorDataType::Float:
+            return FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, TArrayView<float>(static_cast<float*>(Data), Num));
+        case ENNETensorDataType::Half:
+            return FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, TArrayView<FFloat16>(static_cast<FFloat16*>(Data), Num));
+        case ENNETensorDataType::UInt8:
+            return FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, TArrayView<uint8>(static_cast<uint8*>(Data), Num));
+        default:
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Image preprocessing supports float, half and uint8 inputs"));
+            return false;
         }
     }
-    return bSuccess;
-}
-
-
-// Retrieves input tensor descriptors from the model instance.
-void ANeuralNetwork::GetInputTensorDescs(bool isModelRunning, int32& numInputs, int32& idxInputs)
-{
-    int32 Inputs;
 
-    if (m_ModelHelper->ModelInstance.IsValid())
+    // Shared by the worker jobs of one tiled inference
+    struct FTiledInferenceJob
+    {
+        TArray<FColor> Pixels;
+        int32 OriginalWidth = 0;
+        int32 ModelHeight = 0;
+        int32 ModelWidth = 0;
+        FNNEImageNormalization Normalization;
+        FNNEPostProcessSettings Settings;
+        ENNEResizeFilter Filter = ENNEResizeFilter::Bilinear;
+        FNNETiledResult Tiled;
+        FNNEAsyncTiledInferenceDelegate Result;
+        std::atomic<int32> NextTile{ 0 };
+        std::atomic<int32> RemainingWorkers{ 0 };
+    };
+
+    // Evenly spaced tile origins along one axis, the last tile sits flush with the image edge
+    void ComputeTileOrigins(int32 ImageSize, int32 TileSize, float Overlap, TArray<int32>& OutOrigins)
     {
-        // Stop the model if it's running
-        if (isModelRunning)
+        OutOrigins.Reset();
+        if (TileSize >= ImageSize)
         {
-            m_mutex.Lock();
-            m_ModelHelper->bIsRunning = false;
-            m_mutex.Unlock();
-            IsModelRunning = false;
+            OutOrigins.Add(0);
+            return;
         }
 
-        // Get input tensor descriptors
-        m_mutex.Lock();
-        InputTensorDescs = m_ModelHelper->ModelInstance->GetInputTensorDescs();
-        m_mutex.Unlock();
-
-        checkf(InputTensorDescs.Num() == 1, TEXT("The current example supports only models with a single input tensor"));
-
-        Inputs = InputTensorDescs.Num();
+        const int32 Stride = FMath::Max(1, FMath::FloorToInt32(TileSize * (1.0f - Overlap)));
+        const int32 NumTiles = FMath::DivideAndRoundUp(ImageSize - TileSize, Stride) + 1;
+        for (int32 TileIdx = 0; TileIdx < NumTiles; ++TileIdx)
+        {
+            OutOrigins.Add(FMath::Min(TileIdx * Stride, ImageSize - TileSize));
+        }
     }
 
-    numInputs = Inputs;
-    idxInputs = Inputs - 1;
-}
-
+    // Values of one cascade tensor, pointing into the cascade input, a glue op buffer or a claimed instance's output
+    struct FCascadeTensor
+    {
+        TConstArrayView<float> Data;
+        TArray<int32> Shape;
+    };
 
-// Retrieves input tensor shape from the model instance.
-void ANeuralNetwork::GetInputTensorShape(int32 InputIdx, bool isModelRunning, int32& Rank, int32& Volume, int32& Dimension, int32& Frame, int32& ColorChannels, int32& Height, int32& Width)
-{
-    if (m_ModelHelper->ModelInstance.IsValid())
+    // Float inputs bind the source tensor in place, other input types are converted into the arena first
+    bool RunCascadeModel(FModelHelper& ModelHelper, const FCascadeTensor& Source, FCascadeTensor& OutTensor)
     {
-        // Stop the model if it's running
-        if (isModelRunning)
+        if (Source.Data.Num() != ModelHelper.GetInputNum(0))
         {
-            m_mutex.Lock();
-            m_ModelHelper->bIsRunning = false;
-            m_mutex.Unlock();
-            IsModelRunning = false;
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Cascade model stage got %d values, the model expects %d"), Source.Data.Num(), ModelHelper.GetInputNum(0));
+            return false;
         }
 
-        // Get symbolic input tensor shape
-        SymbolicInputTensorShape = InputTensorDescs[InputIdx].GetShape();
+        TArray<UE::NNE::FTensorBindingCPU, TInlineAllocator<1>> InputBindings(ModelHelper.InputBindings);
+        if (ModelHelper.InputDataTypes[0] == ENNETensorDataType::Float)
+        {
+            // The runtime only reads its inputs
+            InputBindings[0].Data = const_cast<float*>(Source.Data.GetData());
+            InputBindings[0].SizeInBytes = Source.Data.Num() * sizeof(float);
+        }
+        else if (!ModelHelper.WriteInput(0, Source.Data))
+        {
+            return false;
+        }
 
-        checkf(SymbolicInputTensorShape.IsConcrete(), TEXT("The current example supports only models without variable input tensor dimensions"));
+        {
+            NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_RunSync);
+            if (ModelHelper.ModelInstance->RunSync(InputBindings, ModelHelper.OutputBindings) != 0)
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to run a cascade model stage"));
+                return false;
+            }
+        }
 
-        InputTensorShapes = { UE::NNE::FTensorShape::MakeFromSymbolic(SymbolicInputTensorShape) };
-    }
-    else
-    {
-        UE_LOG(LogTemp, Display, TEXT("No Valid Model Instance in Model Helper"));
+        OutTensor.Data = ModelHelper.ReadOutput(0);
+        OutTensor.Shape.Reset();
+        for (uint32 Dim : ModelHelper.OutputShapes[0].GetData())
+        {
+            OutTensor.Shape.Add(Dim);
+        }
+        return true;
     }
 
-    Rank = InputTensorShapes[InputIdx].Rank();
-    Volume = InputTensorShapes[InputIdx].Volume();
-    Dimension = InputTensorShapes[InputIdx].GetData()[0];
-
-    if (Rank == 4)
-    {
-        Frame = 0;
-        ColorChannels = InputTensorShapes[InputIdx].GetData()[1];
-        Height = InputTensorShapes[InputIdx].GetData()[2];
-        Width = InputTensorShapes[InputIdx].GetData()[3];
-    }
-    if (Rank == 5)
+    // Finishes the request as dropped when a worker job is destroyed without having run, e.g. by the executor shutting down
+    struct FRequestAbandonGuard
     {
-        Frame = InputTensorShapes[InputIdx].GetData()[1];
-        ColorChannels = InputTensorShapes[InputIdx].GetData()[2];
-        Height = InputTensorShapes[InputIdx].GetData()[3];
-        Width = InputTensorShapes[InputIdx].GetData()[4];
-    }
-}
+        TSharedPtr<FNeuralNetworkRequest, ESPMode::ThreadSafe> Request;
 
+        explicit FRequestAbandonGuard(TSharedPtr<FNeuralNetworkRequest, ESPMode::ThreadSafe> InRequest)
+            : Request(MoveTemp(InRequest))
+        {
+        }
 
-// Retrieves output tensor descriptors from the model instance.
-int32 ANeuralNetwork::GetOutputTensorDescs(bool isModelRunning)
-{
-    int32 Outputs;
+        FRequestAbandonGuard(FRequestAbandonGuard&&) = default;
 
-    if (m_ModelHelper->ModelInstance.IsValid())
-    {
-        // Stop the model if it's running
-        if (isModelRunning)
+        ~FRequestAbandonGuard()
         {
-            m_mutex.Lock();
-            m_ModelHelper->bIsRunning = false;
-            m_mutex.Unlock();
-            IsModelRunning = false;
+            if (Request.IsValid())
+            {
+                Request->Drop();
+            }
         }
+    };
+}
 
-        // Get output tensor descriptors
-        m_mutex.Lock();
-        OutputTensorDescs = m_ModelHelper->ModelInstance->GetOutputTensorDescs();
-        m_mutex.Unlock();
 
-        checkf(OutputTensorDescs.Num() == 1, TEXT("The current example supports only models with a single output tensor"));
+std::atomic<int64> FNeuralNetworkRequest::NextId{ 1 };
 
-        Outputs = OutputTensorDescs.Num();
-    }
 
-    return Outputs;
+FNeuralNetworkRequest::FNeuralNetworkRequest(bool bInKeepOutputs)
+    : Id(NextId.fetch_add(1, std::memory_order_relaxed))
+    , bKeepOutputs(bInKeepOutputs)
+    , Status(static_cast<uint8>(ENNERequestStatus::Queued))
+{
 }
 
 
-// Retrieves output tensor shape from the model instance.
-void ANeuralNetwork::GetOutputTensorShape(int32 OutputIdx, bool isModelRunning, int32& Rank, int32& Volume, int32& Dimension, int32& PredOpts)
+bool FNeuralNetworkRequest::IsDone() const
 {
-    if (m_ModelHelper->ModelInstance.IsValid())
-    {
-        // Stop the model if it's running
-        if (isModelRunning)
-        {
-            m_mutex.Lock();
-            m_ModelHelper->bIsRunning = false;
-            m_mutex.Unlock();
-            IsModelRunning = false;
-        }
+    const ENNERequestStatus Current = GetStatus();
+    return Current == ENNERequestStatus::Completed || Current == ENNERequestStatus::Cancelled || Current == ENNERequestStatus::Dropped;
+}
 
-        // Get symbolic output tensor shape
-        SymbolicOutputTensorShape = OutputTensorDescs[OutputIdx].GetShape();
 
-        checkf(SymbolicOutputTensorShape.IsConcrete(), TEXT("The current example supports only models without variable input tensor dimensions"));
+bool FNeuralNetworkRequest::Wait(uint32 TimeoutMs) const
+{
+    return IsDone() || (DoneEvent->Wait(TimeoutMs) && IsDone());
+}
 
-        OutputTensorShapes = { UE::NNE::FTensorShape::MakeFromSymbolic(SymbolicOutputTensorShape) };
-    }
-    else
-    {
-        UE_LOG(LogTemp, Display, TEXT("No Valid Model Instance in Model Helper"));
-    }
 
-    Rank = OutputTensorShapes[OutputIdx].Rank();
-    Volume = OutputTensorShapes[OutputIdx].Volume();
-    Dimension = OutputTensorShapes[OutputIdx].GetData()[0];
-    PredOpts = OutputTensorShapes[OutputIdx].GetData()[1];
+bool FNeuralNetworkRequest::Cancel()
+{
+    return Finish(ENNERequestStatus::Queued, ENNERequestStatus::Cancelled);
 }
 
 
-// Sets input tensor shapes in the model instance.
-void ANeuralNetwork::SetInputTensorShapes(bool isModelRunning, int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width)
+bool FNeuralNetworkRequest::TryStart()
 {
-    // MUST BE CALLED ANYTIME INPUT SHAPE CHANGES i.e. image dimensions are different
+    uint8 Expected = static_cast<uint8>(ENNERequestStatus::Queued);
+    return Status.compare_exchange_strong(Expected, static_cast<uint8>(ENNERequestStatus::Running), std::memory_order_acq_rel);
+}
 
-    TArray<uint32> InputShapeData;
 
-    if (isModelRunning)
-    {
-        m_mutex.Lock();
-        m_ModelHelper->bIsRunning = false;
-        m_mutex.Unlock();
-        IsModelRunning = false;
-    }
-    if (Rank == 4)
-    {
-        InputShapeData.Emplace(Dimension);
-        InputShapeData.Emplace(ColorChannels);
-        InputShapeData.Emplace(Height);
-        InputShapeData.Emplace(Width);
-    }
-    if (Rank == 5)
+// The outputs are written before the status is released, so a reader that sees Completed also sees them.
+void FNeuralNetworkRequest::Complete(TArray<FNNETensorData> InOutputs)
+{
+    if (GetStatus() != ENNERequestStatus::Running)
     {
-        InputShapeData.Emplace(Dimension);
-        InputShapeData.Emplace(Frame);
-        InputShapeData.Emplace(ColorChannels);
-        InputShapeData.Emplace(Height);
-        InputShapeData.Emplace(Width);
+        return;
     }
-    if (InputShapeData.Num() == Rank)
-    {
-        TArray<UE::NNE::FTensorShape> TensorShapes;
 
-        UE::NNE::FTensorShape Shape = UE::NNE::FTensorShape::Make(InputShapeData);
-        TensorShapes.Emplace(Shape);
-        m_mutex.Lock();
-        m_ModelHelper->ModelInstance->SetInputTensorShapes(TensorShapes);
-        m_mutex.Unlock();
-    }
-    else
+    Outputs = MoveTemp(InOutputs);
+    Finish(ENNERequestStatus::Running, ENNERequestStatus::Completed);
+}
+
+
+// Requests are dropped either before they were admitted or after their job was abandoned.
+void FNeuralNetworkRequest::Drop()
+{
+    if (!Finish(ENNERequestStatus::Queued, ENNERequestStatus::Dropped))
     {
-        m_mutex.Lock();
-        m_ModelHelper->ModelInstance->SetInputTensorShapes(InputTensorShapes);
-        m_mutex.Unlock();
+        Finish(ENNERequestStatus::Running, ENNERequestStatus::Dropped);
     }
 }
 
 
-// Creates input tensor bindings for the model instance.
-void ANeuralNetwork::CreateInputTensorBinding(bool isModelRunning, bool& InBSuccess)
+bool FNeuralNetworkRequest::Finish(ENNERequestStatus From, ENNERequestStatus To)
 {
-    InBSuccess = false;
-
-    if (isModelRunning)
+    uint8 Expected = static_cast<uint8>(From);
+    if (!Status.compare_exchange_strong(Expected, static_cast<uint8>(To), std::memory_order_acq_rel))
     {
-        m_mutex.Lock();
-        m_ModelHelper->bIsRunning = false;
-        m_mutex.Unlock();
-        IsModelRunning = false;
+        return false;
     }
 
-    // Lock Access
-    m_mutex.Lock();
-
-    // Example for creating in- and outputs
-    m_ModelHelper->InputData.SetNumZeroed(InputTensorShapes[0].Volume());
-    m_ModelHelper->InputBindings.SetNumZeroed(1);
-    m_ModelHelper->InputBindings[0].Data = m_ModelHelper->InputData.GetData();
-    m_ModelHelper->InputBindings[0].SizeInBytes = m_ModelHelper->InputData.Num() * sizeof(float);
+    DoneEvent->Trigger();
+    return true;
+}
 
-    m_mutex.Unlock();
 
-    InBSuccess = true;
+// Lays out every tensor in one aligned allocation and points the bindings into it, each tensor sized for its own element type.
+void FModelHelper::AllocateTensorArena(TConstArrayView<UE::NNE::FTensorShape> InInputShapes, TConstArrayView<UE::NNE::FTensorShape> InOutputShapes)
+{
+    // Tensors without a desc, e.g. before the instance exists, fall back to float
+    auto ReadDataTypes = [](TConstArrayView<UE::NNE::FTensorDesc> Descs, int32 Num, TArray<ENNETensorDataType>& OutDataTypes)
+        {
+            OutDataTypes.SetNum(Num);
+            for (int32 Idx = 0; Idx < Num; ++Idx)
+            {
+                const ENNETensorDataType DataType = Descs.IsValidIndex(Idx) ? Descs[Idx].GetDataType() : ENNETensorDataType::Float;
+                OutDataTypes[Idx] = FNeuralNetworkTensorTypes::GetElementSize(DataType) > 0 ? DataType : ENNETensorDataType::Float;
+            }
+        };
 
-    // Log the new length of InputData after appending
-    UE_LOG(LogTemp, Warning, TEXT("Completed! Input Bindings Created: %d"), m_ModelHelper->InputBindings.Num());
-}
+    ReadDataTypes(ModelInstance.IsValid() ? ModelInstance->GetInputTensorDescs() : TConstArrayView<UE::NNE::FTensorDesc>(), InInputShapes.Num(), InputDataTypes);
+    ReadDataTypes(ModelInstance.IsValid() ? ModelInstance->GetOutputTensorDescs() : TConstArrayView<UE::NNE::FTensorDesc>(), InOutputShapes.Num(), OutputDataTypes);
 
+    auto AlignedSize = [](const UE::NNE::FTensorShape& Shape, ENNETensorDataType DataType)
+        {
+            return Align(Shape.Volume() * FNeuralNetworkTensorTypes::GetElementSize(DataType), TensorAlignment);
+        };
 
-// Creates output tensor bindings for the model instance.
-void ANeuralNetwork::CreateOutputTensorBinding(bool isModelRunning, bool& OutBSuccess)
-{
-    OutBSuccess = false;
+    uint64 ArenaSize = 0;
+    for (int32 InputIdx = 0; InputIdx < InInputShapes.Num(); ++InputIdx)
+    {
+        ArenaSize += AlignedSize(InInputShapes[InputIdx], InputDataTypes[InputIdx]);
+    }
+    for (int32 OutputIdx = 0; OutputIdx < InOutputShapes.Num(); ++OutputIdx)
+    {
+        ArenaSize += AlignedSize(InOutputShapes[OutputIdx], OutputDataTypes[OutputIdx]);
+    }
 
-    if (isModelRunning)
+    // Same layout as before keeps the existing arena and its contents
+    if ((uint64)TensorArena.Num() != ArenaSize)
     {
-        m_mutex.Lock();
-        m_ModelHelper->bIsRunning = false;
-        m_mutex.Unlock();
-        IsModelRunning = false;
+        TensorArena.Empty((int32)ArenaSize);
+        TensorArena.SetNumZeroed((int32)ArenaSize);
     }
 
-    m_mutex.Lock();
+    uint8* Cursor = TensorArena.GetData();
 
-    m_ModelHelper->OutputData.SetNumZeroed(OutputTensorShapes[0].Volume());
-    m_ModelHelper->OutputBindings.SetNumZeroed(1);
-    m_ModelHelper->OutputBindings[0].Data = m_ModelHelper->OutputData.GetData();
-    m_ModelHelper->OutputBindings[0].SizeInBytes = m_ModelHelper->OutputData.Num() * sizeof(float);
+    InputBindings.SetNumZeroed(InInputShapes.Num());
+    for (int32 InputIdx = 0; InputIdx < InInputShapes.Num(); ++InputIdx)
+    {
+        InputBindings[InputIdx].Data = Cursor;
+        InputBindings[InputIdx].SizeInBytes = InInputShapes[InputIdx].Volume() * FNeuralNetworkTensorTypes::GetElementSize(InputDataTypes[InputIdx]);
+        Cursor += AlignedSize(InInputShapes[InputIdx], InputDataTypes[InputIdx]);
+    }
 
-    m_mutex.Unlock();
+    OutputBindings.SetNumZeroed(InOutputShapes.Num());
+    for (int32 OutputIdx = 0; OutputIdx < InOutputShapes.Num(); ++OutputIdx)
+    {
+        OutputBindings[OutputIdx].Data = Cursor;
+        OutputBindings[OutputIdx].SizeInBytes = InOutputShapes[OutputIdx].Volume() * FNeuralNetworkTensorTypes::GetElementSize(OutputDataTypes[OutputIdx]);
+        Cursor += AlignedSize(InOutputShapes[OutputIdx], OutputDataTypes[OutputIdx]);
+    }
 
-    OutBSuccess = true;
+    OutputConversion.SetNum(InOutputShapes.Num());
 
-    // Log the new length of InputData after appending
-    UE_LOG(LogTemp, Warning, TEXT("Completed! Output Bindings Created: %d"), m_ModelHelper->OutputBindings.Num());
+    OutputShapes = TArray<UE::NNE::FTensorShape>(InOutputShapes.GetData(), InOutputShapes.Num());
 }
 
 
-// Converts UTextureRenderTarget2D to a pixel buffer.
-void ANeuralNetwork::RT2PixelBuffer(UTextureRenderTarget2D* InputRT, TArray<FColor>& ImagePixelBuffer, int32& OriginalHeight, int32& OriginalWidth)
+bool FModelHelper::TryAcquire()
 {
-    OriginalHeight = InputRT->SizeY;
-    OriginalWidth = InputRT->SizeX;
+    bool bExpected = false;
+    return bIsRunning.compare_exchange_strong(bExpected, true);
+}
 
-    // Check for valid dimensions
-    if (OriginalWidth <= 0)
-    {
-        UE_LOG(LogTemp, Display, TEXT("Image Dimension Error, width is %f"), OriginalWidth)
-    }
-    if (OriginalHeight <= 0)
+
+TArrayView<float> FModelHelper::GetInputData(int32 InputIdx) const
+{
+    if (!InputBindings.IsValidIndex(InputIdx) || InputDataTypes[InputIdx] != ENNETensorDataType::Float)
     {
-        UE_LOG(LogTemp, Display, TEXT("Image Dimension Error, height is %f"), OriginalHeight)
+        return TArrayView<float>();
     }
-
-    ImagePixelBuffer.SetNumZeroed(OriginalHeight * OriginalWidth);
-
-    InputRT->GameThread_GetRenderTargetResource()->ReadPixels(ImagePixelBuffer);
+    return TArrayView<float>(static_cast<float*>(InputBindings[InputIdx].Data), InputBindings[InputIdx].SizeInBytes / sizeof(float));
 }
 
 
-// Resizes an image using linear interpolation.
-void ANeuralNetwork::ResizeImage(TArray<FColor> ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, TArray<FLinearColor>& ResizedPixelBuffer, int32& ResizedHeight, int32& ResizedWidth)
+TArrayView<float> FModelHelper::GetOutputData(int32 OutputIdx) const
 {
-    TArray<FLinearColor> LinearColorArray;
-    LinearColorArray.SetNumUninitialized(OriginalWidth * OriginalHeight);
-
-    ParallelFor(OriginalWidth * OriginalHeight, [&](int32 Idx)
-        {
-            LinearColorArray[Idx] = FLinearColor(ImagePixelBuffer[Idx]);
-        });
-    if (!ResizedPixelBuffer.IsEmpty())
+    if (!OutputBindings.IsValidIndex(OutputIdx) || OutputDataTypes[OutputIdx] != ENNETensorDataType::Float)
     {
-        ResizedPixelBuffer.Reset();
+        return TArrayView<float>();
     }
+    return TArrayView<float>(static_cast<float*>(OutputBindings[OutputIdx].Data), OutputBindings[OutputIdx].SizeInBytes / sizeof(float));
+}
 
-    ResizedPixelBuffer.SetNumZeroed(ResizeWidth * ResizeHeight);
 
-    FImageUtils::ImageResize(OriginalWidth, OriginalHeight, LinearColorArray, ResizeWidth, ResizeHeight, ResizedPixelBuffer);
+int32 FModelHelper::GetInputNum(int32 InputIdx) const
+{
+    if (!InputBindings.IsValidIndex(InputIdx))
+    {
+        return 0;
+    }
+    return static_cast<int32>(InputBindings[InputIdx].SizeInBytes / FNeuralNetworkTensorTypes::GetElementSize(InputDataTypes[InputIdx]));
+}
 
-    ResizedHeight = ResizeHeight;
-    ResizedWidth = ResizeWidth;
 
-    for (FLinearColor colorValue : ResizedPixelBuffer)
+bool FModelHelper::WriteInput(int32 InputIdx, TConstArrayView<float> Values)
+{
+    if (Values.Num() != GetInputNum(InputIdx))
     {
-        UE_LOG(LogTemp, Error, TEXT("Resized Pixel Buffer, Red: %f, Blue: %f, Green: %f"), colorValue.R, colorValue.G, colorValue.B)
+        return false;
     }
+    return FNeuralNetworkTensorTypes::FromFloat(Values, InputDataTypes[InputIdx], InputBindings[InputIdx].Data);
 }
 
 
-// Normalizes an image to a flat array of float values.
-void ANeuralNetwork::NormalizeImage(TArray<FLinearColor> ImageBuffer, int32 ColorChannels, TArray<float>& FlatImg)
+// Float outputs are returned in place, anything else is widened into a buffer reused across runs.
+TConstArrayView<float> FModelHelper::ReadOutput(int32 OutputIdx)
 {
-    if (!FlatImg.IsEmpty())
+    if (!OutputBindings.IsValidIndex(OutputIdx))
     {
-        FlatImg.Reset();
+        return TConstArrayView<float>();
     }
-    FlatImg.SetNumZeroed(ImageBuffer.Num() * ColorChannels);
-    UE_LOG(LogTemp, Error, TEXT("FlatImg, setsumzeroed length: %d"), FlatImg.Num())
 
-        TArray<float> temp;
-    if (!temp.IsEmpty())
+    const ENNETensorDataType DataType = OutputDataTypes[OutputIdx];
+    if (DataType == ENNETensorDataType::Float)
     {
-        temp.Reset();
+        return GetOutputData(OutputIdx);
     }
 
-    temp.SetNumZeroed(ImageBuffer.Num() * ColorChannels);
-    UE_LOG(LogTemp, Error, TEXT("temp, setsumuninitialized length: %d"), temp.Num())
+    TArray<float>& Converted = OutputConversion[OutputIdx];
+    Converted.SetNumUninitialized(OutputBindings[OutputIdx].SizeInBytes / FNeuralNetworkTensorTypes::GetElementSize(DataType), false);
+    if (!FNeuralNetworkTensorTypes::ToFloat(OutputBindings[OutputIdx].Data, DataType, Converted))
+    {
+        return TConstArrayView<float>();
+    }
 
+    return Converted;
+}
 
-    // Average the RGB Pixel Values to aquire a Grayscale value
-    ParallelFor(ImageBuffer.Num(), [&](int32 Idx)
-        {
-            float GrayValue = FMath::Lerp(ImageBuffer[Idx].R, FMath::Lerp(ImageBuffer[Idx].G, ImageBuffer[Idx].B, 0.33f), 0.33f);
 
-            m_mutex.Lock();
-            temp[Idx] = GrayValue;
-            m_mutex.Unlock();
-        });
+ANeuralNetwork::ANeuralNetwork()
+{
+    // Set this actor to call Tick() every frame. You can turn this off to improve performance if you don't need it.
+    PrimaryActorTick.bCanEverTick = true;
 
-    UE_LOG(LogTemp, Error, TEXT("temp, before handoff length: %d"), temp.Num())
+    m_InferenceLatency = MakeShared<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe>();
+    m_RunSyncLatency = MakeShared<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe>();
+    m_InstanceFreed = MakeShared<FEventRef, ESPMode::ThreadSafe>(EEventMode::AutoReset);
+}
 
-        // Copy temp array to FlatImg after the loop
-        FlatImg = temp;
 
-    for (float value : FlatImg)
+// Asynchronously loads model data and calls OnModelDataLoaded when complete.
+void ANeuralNetwork::LoadModelDataAsync()
+{
+    if (LazyLoadedModelData.IsNull())
     {
-        UE_LOG(LogTemp, Error, TEXT("FlatImg, Value: %f"), value)
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LazyLoadedModelData is not set, please assign it in the editor"));
+    }
+    else
+    {
+        // Async Load Model Data and call OnModelDataLoaded when complete
+        UAssetManager::GetStreamableManager().RequestAsyncLoad(LazyLoadedModelData.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ANeuralNetwork::OnModelDataLoaded));
     }
-
-    UE_LOG(LogTemp, Error, TEXT("FlatImg, to temp length: %d"), FlatImg.Num())
-        temp.Reset();
-    UE_LOG(LogTemp, Error, TEXT("temp, after reset length: %d"), temp.Num())
 }
 
 
-// Runs an asynchronous inference using the model instance.
-void ANeuralNetwork::RunAsyncInference(bool InBSuccess, bool OutBSuccess, TArray<float> InputData, FNNEAsyncInferenceDelegate Result)
-{
-    double InferenceStarted = FPlatformTime::Seconds();
+// Create Model and set the Model Helper
+bool ANeuralNetwork::CreateCPUModel()
+{
+    bool bSuccess = false;
+
+      // Check that model data is loaded and valid
+    if (LazyLoadedModelData.IsValid())
+    {
+        // Log the name of the loaded model
+        UE_LOG(LogNeuralNetwork, Display, TEXT("LazyLoadedModelData loaded %s"), *LazyLoadedModelData.Get()->GetName());
+
+        // Create NNE Runtime
+        TWeakInterfacePtr<INNERuntimeCPU> Runtime = UE::NNE::GetRuntime<INNERuntimeCPU>(FString(CPURuntimeName));
+        if (Runtime.IsValid())
+        {
+            // Create or share the model, then a pool of model instances from it
+            FSharedModelCPU NewModel = CreateModel(GetModelRegistry(), *Runtime, LazyLoadedModelData.Get());
+
+            if (NewModel.IsValid())
+            {
+                TArray<TSharedPtr<FModelHelper>> NewPool;
+                if (CreateModelHelperPool(NewModel, FMath::Max(1, NumModelInstances), NewPool))
+                {
+                    // Model creation successful
+                    InstallModel(MoveTemp(NewModel), MoveTemp(NewPool));
+                    bSuccess = true;
+
+                    UE_LOG(LogNeuralNetwork, Display, TEXT("Created %d Model Instances"), m_ModelHelperPool.Num());
+                }
+            }
+            else
+            {
+                UE_LOG(LogNeuralNetwork, Display, TEXT("Failed to create Model"));
+            }
+        }
+        else
+        {
+            UE_LOG(LogNeuralNetwork, Display, TEXT("Failed to create Runtime"));
+        }
+    }
+    return bSuccess;
+}
+
+
+// Creates the model and instances on a background thread, warms every instance up there and reports back on the game thread.
+void ANeuralNetwork::CreateCPUModelAsync()
+{
+    if (m_bModelCreationPending)
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("CreateCPUModelAsync is already in progress"));
+        return;
+    }
+
+    TWeakInterfacePtr<INNERuntimeCPU> Runtime = UE::NNE::GetRuntime<INNERuntimeCPU>(FString(CPURuntimeName));
+    if (!LazyLoadedModelData.IsValid() || !Runtime.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("CreateCPUModelAsync needs loaded model data and the NNERuntimeORTCpu runtime"));
+        OnModelReady(false, 0.0f);
+        return;
+    }
+
+    m_bModelCreationPending = true;
+    m_bModelReady = false;
+
+    INNERuntimeCPU* RuntimePtr = Runtime.Get();
+    UNeuralNetworkModelRegistry* Registry = GetModelRegistry();
+    // Keeps the asset alive for as long as the task works on it, released again on the game thread
+    TStrongObjectPtr<UNNEModelData> ModelData(LazyLoadedModelData.Get());
+    TWeakObjectPtr<ANeuralNetwork> WeakThis(this);
+    const int32 NumInstances = FMath::Max(1, NumModelInstances);
+    const int32 MaxWarmUpRuns = NumWarmUpRuns;
+    const float Tolerance = WarmUpTolerance;
+    const double Started = FPlatformTime::Seconds();
+
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [RuntimePtr, Registry, ModelData = MoveTemp(ModelData), WeakThis, NumInstances, MaxWarmUpRuns, Tolerance, Started]() mutable
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_CreateModelAsync);
+
+            FSharedModelCPU NewModel = CreateModel(Registry, *RuntimePtr, ModelData.Get());
+            TArray<TSharedPtr<FModelHelper>> NewPool;
+            const bool bCreated = NewModel.IsValid() && CreateModelHelperPool(NewModel, NumInstances, NewPool);
+
+            if (bCreated)
+            {
+                for (const TSharedPtr<FModelHelper>& ModelHelper : NewPool)
+                {
+                    WarmUpModelHelper(*ModelHelper, MaxWarmUpRuns, Tolerance);
+                }
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, ModelData = MoveTemp(ModelData), NewModel = MoveTemp(NewModel), NewPool = MoveTemp(NewPool), bCreated, Started]() mutable
+                {
+                    ModelData.Reset();
+
+                    // A destroyed actor simply drops the model and instances with this task
+                    ANeuralNetwork* This = WeakThis.Get();
+                    if (!This)
+                    {
+                        return;
+                    }
+
+                    This->m_bModelCreationPending = false;
+
+                    const float SecondsToReady = static_cast<float>(FPlatformTime::Seconds() - Started);
+                    if (bCreated)
+                    {
+                        This->InstallModel(MoveTemp(NewModel), MoveTemp(NewPool));
+                        UE_LOG(LogNeuralNetwork, Display, TEXT("Model ready after %.3f s with %d warmed up instances"), SecondsToReady, This->m_ModelHelperPool.Num());
+                    }
+                    else
+                    {
+                        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to create the model or its instances"));
+                    }
+
+                    This->OnModelReady(bCreated, SecondsToReady);
+                });
+        });
+}
+
+
+bool ANeuralNetwork::IsModelReady() const
+{
+    return m_bModelReady;
+}
+
+
+bool ANeuralNetwork::IsModelCreationPending() const
+{
+    return m_bModelCreationPending;
+}
+
+
+// Makes the new model and pool active, any prepared shape configurations belonged to the previous model.
+void ANeuralNetwork::InstallModel(FSharedModelCPU NewModel, TArray<TSharedPtr<FModelHelper>> NewPool)
+{
+    m_mutex.Lock();
+    Model = MoveTemp(NewModel);
+    m_ModelHelperPool = MoveTemp(NewPool);
+    m_ModelHelper = m_ModelHelperPool[0];
+    m_ShapeCache.Reset();
+    m_mutex.Unlock();
+
+    // Results of the previous model must not be served for the new one
+    ClearResultCache();
+
+    IsModelRunning = false;
+    m_bModelReady = true;
+}
+
+
+// The engine-wide registry, so actors in every world and commandlets share models.
+UNeuralNetworkModelRegistry* ANeuralNetwork::GetModelRegistry() const
+{
+    return bUseSharedModelRegistry && GEngine ? GEngine->GetEngineSubsystem<UNeuralNetworkModelRegistry>() : nullptr;
+}
+
+
+// Creates NumInstances model instances from the model, each wrapped in its own helper.
+bool ANeuralNetwork::CreateModelHelperPool(const FSharedModelCPU& InModel, int32 NumInstances, TArray<TSharedPtr<FModelHelper>>& OutPool)
+{
+    OutPool.Reset(NumInstances);
+
+    for (int32 InstanceIdx = 0; InstanceIdx < NumInstances; ++InstanceIdx)
+    {
+        TSharedPtr<FModelHelper> ModelHelper = MakeShared<FModelHelper>();
+        ModelHelper->ModelInstance = InModel->CreateModelInstance();
+        ModelHelper->Model = InModel;
+
+        if (!ModelHelper->ModelInstance.IsValid())
+        {
+            UE_LOG(LogNeuralNetwork, Display, TEXT("Failed to create Model Instance %d"), InstanceIdx);
+            return false;
+        }
+
+        ModelHelper->bIsRunning = false;
+        OutPool.Emplace(MoveTemp(ModelHelper));
+    }
+
+    return true;
+}
+
+
+// Binds zeroed tensors at the model's fixed shapes and runs them until two consecutive runs take about as long.
+void ANeuralNetwork::WarmUpModelHelper(FModelHelper& ModelHelper, int32 MaxRuns, float Tolerance)
+{
+    UE::NNE::IModelInstanceCPU& Instance = *ModelHelper.ModelInstance;
+
+    TArray<UE::NNE::FTensorShape> InputShapes;
+    TConstArrayView<UE::NNE::FTensorDesc> InputDescs = Instance.GetInputTensorDescs();
+    for (int32 InputIdx = 0; InputIdx < InputDescs.Num(); ++InputIdx)
+    {
+        if (!InputDescs[InputIdx].GetShape().IsConcrete())
+        {
+            UE_LOG(LogNeuralNetwork, Display, TEXT("Skipping warm-up, input %d has variable dimensions"), InputIdx);
+            return;
+        }
+        InputShapes.Add(UE::NNE::FTensorShape::MakeFromSymbolic(InputDescs[InputIdx].GetShape()));
+    }
+
+    if (MaxRuns <= 0 || Instance.SetInputTensorShapes(InputShapes) != 0)
+    {
+        return;
+    }
+
+    TConstArrayView<UE::NNE::FTensorShape> OutputShapes = Instance.GetOutputTensorShapes();
+    if (OutputShapes.Num() != Instance.GetOutputTensorDescs().Num())
+    {
+        return;
+    }
+
+    // The arena stays allocated, binding the same shapes later reuses it
+    ModelHelper.AllocateTensorArena(InputShapes, OutputShapes);
+
+    double PreviousRun = 0.0;
+    for (int32 Run = 0; Run < MaxRuns; ++Run)
+    {
+        const double Started = FPlatformTime::Seconds();
+        if (Instance.RunSync(ModelHelper.InputBindings, ModelHelper.OutputBindings) != 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Warm-up run failed"));
+            return;
+        }
+        const double Duration = FPlatformTime::Seconds() - Started;
+
+        // The first run carries the one time initialization, later runs converge on the steady state
+        if (Run > 0 && FMath::Abs(Duration - PreviousRun) <= Tolerance * PreviousRun)
+        {
+            break;
+        }
+        PreviousRun = Duration;
+    }
+}
+
+
+// Retrieves input tensor descriptors from the model instance.
+void ANeuralNetwork::GetInputTensorDescs(bool isModelRunning, int32& numInputs, int32& idxInputs)
+{
+    int32 Inputs = 0;
+
+    if (m_ModelHelper.IsValid() && m_ModelHelper->ModelInstance.IsValid())
+    {
+        // Get input tensor descriptors
+        m_mutex.Lock();
+        InputTensorDescs = m_ModelHelper->ModelInstance->GetInputTensorDescs();
+        m_mutex.Unlock();
+
+        Inputs = InputTensorDescs.Num();
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("No Valid Model Instance in Model Helper"));
+    }
+
+    // -1 when there are no inputs
+    numInputs = Inputs;
+    idxInputs = Inputs - 1;
+}
+
+
+// Retrieves input tensor shape from the model instance.
+void ANeuralNetwork::GetInputTensorShape(int32 InputIdx, bool isModelRunning, int32& Rank, int32& Volume, int32& Dimension, int32& Frame, int32& ColorChannels, int32& Height, int32& Width)
+{
+    if (m_ModelHelper->ModelInstance.IsValid())
+    {
+        // Get symbolic input tensor shape
+        SymbolicInputTensorShape = InputTensorDescs[InputIdx].GetShape();
+
+        if (SymbolicInputTensorShape.IsConcrete())
+        {
+            // One shape slot per input, the other inputs keep whatever was resolved for them
+            if (InputTensorShapes.Num() < InputTensorDescs.Num())
+            {
+                const int32 NumResolved = InputTensorShapes.Num();
+                InputTensorShapes.SetNum(InputTensorDescs.Num());
+
+                // Inputs not queried yet take their fixed shape from the model, variable ones stay unset until SetInputTensorShapes
+                for (int32 OtherIdx = NumResolved; OtherIdx < InputTensorDescs.Num(); ++OtherIdx)
+                {
+                    const UE::NNE::FSymbolicTensorShape& OtherShape = InputTensorDescs[OtherIdx].GetShape();
+                    if (OtherShape.IsConcrete())
+                    {
+                        InputTensorShapes[OtherIdx] = UE::NNE::FTensorShape::MakeFromSymbolic(OtherShape);
+                    }
+                }
+            }
+            InputTensorShapes[InputIdx] = UE::NNE::FTensorShape::MakeFromSymbolic(SymbolicInputTensorShape);
+        }
+        else if (!InputTensorShapes.IsValidIndex(InputIdx) || !InputTensorShapes[InputIdx].IsCompatibleWith(SymbolicInputTensorShape))
+        {
+            // Variable dimensions are reported as -1 until a concrete shape is chosen with ActivateInputShape
+            TConstArrayView<int32> SymbolicDims = SymbolicInputTensorShape.GetData();
+            GetImageDims(SymbolicDims, Rank, Dimension, Frame, ColorChannels, Height, Width);
+            Volume = 0;
+            return;
+        }
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("No Valid Model Instance in Model Helper"));
+    }
+
+    TArray<int32> Dims;
+    for (uint32 Dim : InputTensorShapes[InputIdx].GetData())
+    {
+        Dims.Add(Dim);
+    }
+
+    GetImageDims(Dims, Rank, Dimension, Frame, ColorChannels, Height, Width);
+    Volume = InputTensorShapes[InputIdx].Volume();
+}
+
+
+// Retrieves output tensor descriptors from the model instance.
+int32 ANeuralNetwork::GetOutputTensorDescs(bool isModelRunning)
+{
+    int32 Outputs = 0;
+
+    if (m_ModelHelper.IsValid() && m_ModelHelper->ModelInstance.IsValid())
+    {
+        // Get output tensor descriptors
+        m_mutex.Lock();
+        OutputTensorDescs = m_ModelHelper->ModelInstance->GetOutputTensorDescs();
+        m_mutex.Unlock();
+
+        Outputs = OutputTensorDescs.Num();
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("No Valid Model Instance in Model Helper"));
+    }
+
+    return Outputs;
+}
+
+
+// Retrieves output tensor shape from the model instance.
+void ANeuralNetwork::GetOutputTensorShape(int32 OutputIdx, bool isModelRunning, int32& Rank, int32& Volume, int32& Dimension, int32& PredOpts)
+{
+    if (m_ModelHelper->ModelInstance.IsValid())
+    {
+        // Get symbolic output tensor shape
+        SymbolicOutputTensorShape = OutputTensorDescs[OutputIdx].GetShape();
+
+        if (SymbolicOutputTensorShape.IsConcrete())
+        {
+            if (OutputTensorShapes.Num() < OutputTensorDescs.Num())
+            {
+                OutputTensorShapes.SetNum(OutputTensorDescs.Num());
+            }
+            OutputTensorShapes[OutputIdx] = UE::NNE::FTensorShape::MakeFromSymbolic(SymbolicOutputTensorShape);
+        }
+        else if (!OutputTensorShapes.IsValidIndex(OutputIdx) || !OutputTensorShapes[OutputIdx].IsCompatibleWith(SymbolicOutputTensorShape))
+        {
+            // Variable dimensions are reported as -1 until a concrete input shape is chosen with ActivateInputShape
+            TConstArrayView<int32> SymbolicDims = SymbolicOutputTensorShape.GetData();
+            Rank = SymbolicDims.Num();
+            Volume = 0;
+            Dimension = Rank > 0 ? SymbolicDims[0] : 0;
+            PredOpts = Rank > 1 ? SymbolicDims[1] : 0;
+            return;
+        }
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("No Valid Model Instance in Model Helper"));
+    }
+
+    Rank = OutputTensorShapes[OutputIdx].Rank();
+    Volume = OutputTensorShapes[OutputIdx].Volume();
+    Dimension = Rank > 0 ? OutputTensorShapes[OutputIdx].GetData()[0] : 0;
+    PredOpts = Rank > 1 ? OutputTensorShapes[OutputIdx].GetData()[1] : 0;
+}
+
+
+// Sets input tensor shapes in the model instance.
+void ANeuralNetwork::SetInputTensorShapes(bool isModelRunning, int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width)
+{
+    // MUST BE CALLED ANYTIME INPUT SHAPE CHANGES i.e. image dimensions are different
+
+    TArray<uint32> InputShapeData = MakeImageShape(Rank, Dimension, Frame, ColorChannels, Height, Width);
+
+    if (InputShapeData.Num() == Rank)
+    {
+        // The image shape goes to the first input, any further inputs keep their current shapes
+        TArray<UE::NNE::FTensorShape> TensorShapes = InputTensorShapes;
+        if (TensorShapes.IsEmpty())
+        {
+            TensorShapes.SetNum(1);
+        }
+        TensorShapes[0] = UE::NNE::FTensorShape::Make(InputShapeData);
+
+        m_mutex.Lock();
+        if (!SwapOutRunningModelHelpers())
+        {
+            m_mutex.Unlock();
+            return;
+        }
+        for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+        {
+            ModelHelper->ModelInstance->SetInputTensorShapes(TensorShapes);
+        }
+
+        // Keep the cached shapes in sync so bindings and batching are sized for the new shape
+        InputTensorShapes = TensorShapes;
+        m_mutex.Unlock();
+    }
+    else
+    {
+        m_mutex.Lock();
+        if (!SwapOutRunningModelHelpers())
+        {
+            m_mutex.Unlock();
+            return;
+        }
+        for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+        {
+            ModelHelper->ModelInstance->SetInputTensorShapes(InputTensorShapes);
+        }
+        m_mutex.Unlock();
+    }
+}
+
+
+// Creates input tensor bindings for the model instance.
+void ANeuralNetwork::CreateInputTensorBinding(bool isModelRunning, bool& InBSuccess)
+{
+    InBSuccess = false;
+
+    if (!m_ModelHelper.IsValid() || !m_ModelHelper->ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("No valid model instance to bind inputs for"));
+        return;
+    }
+
+    // The arenas are sized from these shapes, so every input needs a real one rather than an empty placeholder
+    TConstArrayView<UE::NNE::FTensorDesc> Descs = m_ModelHelper->ModelInstance->GetInputTensorDescs();
+    if (InputTensorShapes.Num() != Descs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Input shapes are set for %d of %d inputs, call GetInputTensorShape or SetInputTensorShapes first"), InputTensorShapes.Num(), Descs.Num());
+        return;
+    }
+    for (int32 InputIdx = 0; InputIdx < Descs.Num(); ++InputIdx)
+    {
+        if (!InputTensorShapes[InputIdx].IsCompatibleWith(Descs[InputIdx].GetShape()))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Input %d has no shape matching the model yet, set it with SetInputTensorShapes first"), InputIdx);
+            return;
+        }
+    }
+
+    // Lock Access
+    m_mutex.Lock();
+
+    if (!SwapOutRunningModelHelpers())
+    {
+        m_mutex.Unlock();
+        return;
+    }
+
+    // Every pooled instance gets its own arena, outputs are laid out too once their shapes are known
+    for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+    {
+        ModelHelper->AllocateTensorArena(InputTensorShapes, ModelHelper->OutputShapes);
+    }
+
+    // Persistent staging buffers are sized once here so BeginInputStaging never allocates
+    m_InputStaging.SetNum(FMath::Max(1, NumInputStagingBuffers));
+    for (TSharedPtr<FInputStagingBuffer>& StagingBuffer : m_InputStaging)
+    {
+        StagingBuffer = MakeShared<FInputStagingBuffer>();
+        StagingBuffer->Allocate(m_ModelHelper->InputDataTypes[0], InputTensorShapes[0].Volume());
+    }
+
+    m_mutex.Unlock();
+
+    // Cached outputs belong to the old input shape
+    ClearResultCache();
+
+    InBSuccess = true;
+
+    // Log the new length of InputData after appending
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Completed! Input Bindings Created: %d"), m_ModelHelper->InputBindings.Num());
+}
+
+
+// Creates output tensor bindings for the model instance.
+void ANeuralNetwork::CreateOutputTensorBinding(bool isModelRunning, bool& OutBSuccess)
+{
+    OutBSuccess = false;
+
+    m_mutex.Lock();
+
+    if (!SwapOutRunningModelHelpers())
+    {
+        m_mutex.Unlock();
+        return;
+    }
+
+    // Relayout with the output shapes, the arena is only reallocated if the total size changed
+    for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+    {
+        ModelHelper->AllocateTensorArena(InputTensorShapes, OutputTensorShapes);
+    }
+
+    m_mutex.Unlock();
+
+    OutBSuccess = true;
+
+    // Log the new length of InputData after appending
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Completed! Output Bindings Created: %d"), m_ModelHelper->OutputBindings.Num());
+}
+
+
+// Activates a prepared configuration for the input shape, building and caching it on first use.
+void ANeuralNetwork::ActivateInputShape(int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width, bool& bSuccess)
+{
+    bSuccess = false;
+
+    if (!Model.IsValid() || !m_ModelHelper.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ActivateInputShape needs a model, call CreateCPUModel first"));
+        return;
+    }
+
+    const TArray<uint32> ShapeData = MakeImageShape(Rank, Dimension, Frame, ColorChannels, Height, Width);
+    if (ShapeData.Num() != Rank)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ActivateInputShape supports rank 4 and rank 5 inputs, got rank %d"), Rank);
+        return;
+    }
+
+    TSharedPtr<FPreparedShapeConfig>* Cached = m_ShapeCache.FindByPredicate([&ShapeData](const TSharedPtr<FPreparedShapeConfig>& Config)
+        {
+            return Config->ShapeKey == ShapeData;
+        });
+
+    TSharedPtr<FPreparedShapeConfig> Config = Cached ? *Cached : PrepareShapeConfig(ShapeData);
+    if (!Config.IsValid())
+    {
+        return;
+    }
+
+    if (!Cached)
+    {
+        // Evict the least recently used configuration that is not active, in-flight inferences keep its instances alive
+        if (m_ShapeCache.Num() >= FMath::Max(1, MaxCachedShapeConfigs))
+        {
+            int32 EvictIdx = INDEX_NONE;
+            for (int32 ConfigIdx = 0; ConfigIdx < m_ShapeCache.Num(); ++ConfigIdx)
+            {
+                const bool bActive = m_ShapeCache[ConfigIdx]->Pool[0] == m_ModelHelper;
+                if (!bActive && (EvictIdx == INDEX_NONE || m_ShapeCache[ConfigIdx]->LastUsed < m_ShapeCache[EvictIdx]->LastUsed))
+                {
+                    EvictIdx = ConfigIdx;
+                }
+            }
+            if (EvictIdx != INDEX_NONE)
+            {
+                m_ShapeCache.RemoveAt(EvictIdx);
+            }
+        }
+        m_ShapeCache.Add(Config);
+    }
+
+    Config->LastUsed = ++m_ShapeCacheClock;
+
+    const bool bShapeChanged = InputTensorShapes != Config->InputShapes;
+
+    m_mutex.Lock();
+    m_ModelHelperPool = Config->Pool;
+    m_ModelHelper = Config->Pool[0];
+    InputTensorShapes = Config->InputShapes;
+    OutputTensorShapes = Config->OutputShapes;
+    m_InputStaging = Config->Staging;
+    m_mutex.Unlock();
+
+    // Reuse matches inputs by their values alone, two shapes of the same volume would otherwise share results
+    if (bShapeChanged)
+    {
+        ClearResultCache();
+    }
+
+    bSuccess = true;
+}
+
+
+// Prepares instances for a shape, reusing the current pool when nothing has claimed it and it is idle.
+TSharedPtr<FPreparedShapeConfig> ANeuralNetwork::PrepareShapeConfig(const TArray<uint32>& ShapeData)
+{
+    TSharedPtr<FPreparedShapeConfig> Config = MakeShared<FPreparedShapeConfig>();
+    Config->ShapeKey = ShapeData;
+
+    const bool bPoolClaimed = m_ShapeCache.ContainsByPredicate([this](const TSharedPtr<FPreparedShapeConfig>& Cached)
+        {
+            return Cached->Pool[0] == m_ModelHelper;
+        });
+
+    if (!bPoolClaimed && GetNumIdleModelInstances() == m_ModelHelperPool.Num())
+    {
+        Config->Pool = m_ModelHelperPool;
+    }
+    else if (!CreateModelHelperPool(Model, FMath::Max(1, NumModelInstances), Config->Pool))
+    {
+        return nullptr;
+    }
+
+    UE::NNE::IModelInstanceCPU& FirstInstance = *Config->Pool[0]->ModelInstance;
+    TConstArrayView<UE::NNE::FTensorDesc> InputDescs = FirstInstance.GetInputTensorDescs();
+    TConstArrayView<UE::NNE::FTensorDesc> OutputDescs = FirstInstance.GetOutputTensorDescs();
+
+    // The key shape drives the first input, further inputs must have fixed shapes
+    for (int32 InputIdx = 0; InputIdx < InputDescs.Num(); ++InputIdx)
+    {
+        const UE::NNE::FSymbolicTensorShape& SymbolicShape = InputDescs[InputIdx].GetShape();
+        if (InputIdx == 0)
+        {
+            Config->InputShapes.Add(UE::NNE::FTensorShape::Make(ShapeData));
+        }
+        else if (SymbolicShape.IsConcrete())
+        {
+            Config->InputShapes.Add(UE::NNE::FTensorShape::MakeFromSymbolic(SymbolicShape));
+        }
+        else
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Input %d has variable dimensions, only the first input can change shape"), InputIdx);
+            return nullptr;
+        }
+
+        if (!Config->InputShapes[InputIdx].IsCompatibleWith(SymbolicShape))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Input shape is not compatible with the model's input tensor %d"), InputIdx);
+            return nullptr;
+        }
+    }
+
+    for (const TSharedPtr<FModelHelper>& ModelHelper : Config->Pool)
+    {
+        if (ModelHelper->ModelInstance->SetInputTensorShapes(Config->InputShapes) != 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to set input tensor shapes"));
+            return nullptr;
+        }
+    }
+
+    // Prefer the shapes the runtime resolved, fall back to the symbolic output shapes
+    TConstArrayView<UE::NNE::FTensorShape> ResolvedOutputShapes = FirstInstance.GetOutputTensorShapes();
+    if (ResolvedOutputShapes.Num() == OutputDescs.Num())
+    {
+        Config->OutputShapes = TArray<UE::NNE::FTensorShape>(ResolvedOutputShapes.GetData(), ResolvedOutputShapes.Num());
+    }
+    else
+    {
+        Config->OutputShapes.SetNum(OutputDescs.Num());
+        for (int32 OutputIdx = 0; OutputIdx < OutputDescs.Num(); ++OutputIdx)
+        {
+            if (!ResolveOutputShape(OutputDescs[OutputIdx].GetShape(), ShapeData[0], Config->OutputShapes[OutputIdx]))
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Could not resolve the shape of output %d"), OutputIdx);
+                return nullptr;
+            }
+        }
+    }
+
+    // Arenas are sized once here, switching back to this shape later allocates nothing
+    for (const TSharedPtr<FModelHelper>& ModelHelper : Config->Pool)
+    {
+        ModelHelper->AllocateTensorArena(Config->InputShapes, Config->OutputShapes);
+    }
+
+    Config->Staging.SetNum(FMath::Max(1, NumInputStagingBuffers));
+    for (TSharedPtr<FInputStagingBuffer>& StagingBuffer : Config->Staging)
+    {
+        StagingBuffer = MakeShared<FInputStagingBuffer>();
+        StagingBuffer->Allocate(Config->Pool[0]->InputDataTypes[0], Config->InputShapes[0].Volume());
+    }
+
+    return Config;
+}
+
+
+// Converts UTextureRenderTarget2D to a pixel buffer.
+void ANeuralNetwork::RT2PixelBuffer(UTextureRenderTarget2D* InputRT, TArray<FColor>& ImagePixelBuffer, int32& OriginalHeight, int32& OriginalWidth)
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Capture);
+
+    OriginalHeight = InputRT->SizeY;
+    OriginalWidth = InputRT->SizeX;
+
+    // Check for valid dimensions
+    if (OriginalWidth <= 0)
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Image Dimension Error, width is %d"), OriginalWidth)
+    }
+    if (OriginalHeight <= 0)
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Image Dimension Error, height is %d"), OriginalHeight)
+    }
+
+    ImagePixelBuffer.SetNumZeroed(OriginalHeight * OriginalWidth);
+
+    InputRT->GameThread_GetRenderTargetResource()->ReadPixels(ImagePixelBuffer);
+}
+
+
+// Replaces the capture source with a pipelined readback of the render target.
+void ANeuralNetwork::SetCaptureRenderTarget(UTextureRenderTarget2D* InputRT)
+{
+    if (InputRT == nullptr)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetCaptureRenderTarget needs a valid render target"));
+        return;
+    }
+
+    SetCaptureSource(MakeShared<FRenderTargetCaptureSource>(InputRT, NumCaptureStagingBuffers));
+}
+
+
+// Replaces the capture source with a CPU test pattern.
+void ANeuralNetwork::SetSyntheticCaptureSource(int32 Width, int32 Height)
+{
+    SetCaptureSource(MakeShared<FSyntheticCaptureSource>(Width, Height));
+}
+
+
+void ANeuralNetwork::SetCaptureSource(TSharedPtr<INeuralNetworkCaptureSource> InCaptureSource)
+{
+    m_CaptureSource = MoveTemp(InCaptureSource);
+}
+
+
+// Starts a capture on the active capture source without waiting for it.
+bool ANeuralNetwork::RequestCapture()
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Capture);
+
+    if (!m_CaptureSource.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("No capture source set, call SetCaptureRenderTarget first"));
+        return false;
+    }
+
+    return m_CaptureSource->RequestCapture();
+}
+
+
+// Returns the oldest finished capture, if any.
+bool ANeuralNetwork::TryGetCapture(TArray<FColor>& ImagePixelBuffer, int32& OriginalHeight, int32& OriginalWidth)
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Capture);
+
+    if (!m_CaptureSource.IsValid())
+    {
+        return false;
+    }
+
+    return m_CaptureSource->TryGetCapture(ImagePixelBuffer, OriginalWidth, OriginalHeight);
+}
+
+
+// Resizes an image with the actor's resize filter.
+void ANeuralNetwork::ResizeImage(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, TArray<FLinearColor>& ResizedPixelBuffer, int32& ResizedHeight, int32& ResizedWidth)
+{
+    ResizedPixelBuffer.SetNumUninitialized(ResizeWidth * ResizeHeight, false);
+
+    // Filters the 8-bit pixels directly, the source is never widened to FLinearColor
+    if (!FNeuralNetworkPreProcessing::ResizePixels(ImagePixelBuffer, OriginalWidth, OriginalHeight, ResizeWidth, ResizeHeight, ResizeFilter, InputNormalization.bSRGBToLinear, ResizedPixelBuffer))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ResizeImage failed for %dx%d to %dx%d"), OriginalWidth, OriginalHeight, ResizeWidth, ResizeHeight);
+        ResizedPixelBuffer.Reset();
+    }
+
+    ResizedHeight = ResizeHeight;
+    ResizedWidth = ResizeWidth;
+
+    if (UE_LOG_ACTIVE(LogNeuralNetworkData, VeryVerbose))
+    {
+        for (FLinearColor colorValue : ResizedPixelBuffer)
+        {
+            UE_LOG(LogNeuralNetworkData, VeryVerbose, TEXT("Resized Pixel Buffer, Red: %f, Green: %f, Blue: %f"), colorValue.R, colorValue.G, colorValue.B)
+        }
+    }
+}
+
+
+// Normalizes an image to a flat array of float values.
+void ANeuralNetwork::NormalizeImage(const TArray<FLinearColor>& ImageBuffer, int32 ColorChannels, TArray<float>& FlatImg)
+{
+    // Mean, std and channel order come from InputNormalization, the channel count from the caller
+    FNNEImageNormalization Normalization = InputNormalization;
+    Normalization.ColorChannels = ColorChannels;
+
+    FlatImg.SetNumUninitialized(ImageBuffer.Num() * ColorChannels, false);
+
+    if (!FNeuralNetworkPreProcessing::LinearColorsToTensor(ImageBuffer, Normalization, FlatImg))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("NormalizeImage failed, ColorChannels must be 1 or 3 and Std must not be zero"));
+        FlatImg.Reset();
+        return;
+    }
+
+    if (UE_LOG_ACTIVE(LogNeuralNetworkData, VeryVerbose))
+    {
+        for (float value : FlatImg)
+        {
+            UE_LOG(LogNeuralNetworkData, VeryVerbose, TEXT("FlatImg, Value: %f"), value)
+        }
+    }
+}
+
+
+// Resizes, converts and normalizes a pixel buffer into a flat tensor without intermediate buffers.
+void ANeuralNetwork::PreProcessImage(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, const FNNEImageNormalization& Normalization, TArray<float>& FlatImg)
+{
+    FlatImg.SetNumUninitialized(ResizeHeight * ResizeWidth * Normalization.ColorChannels, false);
+
+    if (!FNeuralNetworkPreProcessing::PixelsToTensor(ImagePixelBuffer, OriginalWidth, OriginalHeight, ResizeWidth, ResizeHeight, ResizeFilter, Normalization, FlatImg))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreProcessImage failed for %dx%d to %dx%dx%d"), OriginalWidth, OriginalHeight, ResizeWidth, ResizeHeight, Normalization.ColorChannels);
+        FlatImg.Reset();
+    }
+}
+
+
+// Layout and channel count follow the model's input shape, the rest of the normalization comes from InputNormalization.
+FInputStagingBuffer* ANeuralNetwork::AcquireImageStaging(FNNEImageNormalization& OutNormalization, int32& OutHeight, int32& OutWidth, int32& OutStagingIdx)
+{
+    OutStagingIdx = INDEX_NONE;
+
+    if (InputTensorShapes.Num() == 0 || InputTensorShapes[0].Rank() != 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreProcessImageToStaging needs a rank 4 input tensor shape"));
+        return nullptr;
+    }
+
+    OutNormalization = InputNormalization;
+    if (!FNeuralNetworkPreProcessing::DescribeImageShape(InputTensorShapes[0].GetData(), OutNormalization.Layout, OutNormalization.ColorChannels, OutHeight, OutWidth))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreProcessImageToStaging could not find a 1 or 3 channel image in the input tensor shape"));
+        return nullptr;
+    }
+
+    return AcquireInputStaging(OutStagingIdx);
+}
+
+
+// Preprocesses a pixel buffer directly into the memory the input binding will point at.
+bool ANeuralNetwork::PreProcessImageToStaging(TConstArrayView<FColor> ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32& OutStagingIdx)
+{
+    OutStagingIdx = INDEX_NONE;
+
+    FNNEImageNormalization Normalization;
+    int32 Height = 0;
+    int32 Width = 0;
+    int32 StagingIdx = INDEX_NONE;
+    FInputStagingBuffer* Staging = AcquireImageStaging(Normalization, Height, Width, StagingIdx);
+    if (!Staging)
+    {
+        return false;
+    }
+
+    // Written in the input's own type, quantized and fp16 models get no float pass at all
+    if (!PixelsToTypedTensor(ImagePixelBuffer, OriginalWidth, OriginalHeight, Width, Height, ResizeFilter, Normalization, Staging->Data.GetData(), Staging->DataType, Staging->Num))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreProcessImageToStaging failed for %dx%d to %dx%dx%d"), OriginalWidth, OriginalHeight, Width, Height, Normalization.ColorChannels);
+        CancelInputStaging(StagingIdx);
+        return false;
+    }
+
+    OutStagingIdx = StagingIdx;
+    return true;
+}
+
+
+// Rolling end to end latency, from request to delegate, and completed inferences per second.
+void ANeuralNetwork::GetInferenceLatencyStats(float& P50Ms, float& P95Ms, float& P99Ms, float& InferencesPerSecond)
+{
+    m_InferenceLatency->GetPercentiles(P50Ms, P95Ms, P99Ms);
+    InferencesPerSecond = m_InferenceLatency->GetThroughput();
+}
+
+
+// Rolling latency of RunSync alone and model runs per second.
+void ANeuralNetwork::GetRunSyncLatencyStats(float& P50Ms, float& P95Ms, float& P99Ms, float& RunsPerSecond)
+{
+    m_RunSyncLatency->GetPercentiles(P50Ms, P95Ms, P99Ms);
+    RunsPerSecond = m_RunSyncLatency->GetThroughput();
+}
+
+
+void ANeuralNetwork::ResetLatencyStats()
+{
+    m_InferenceLatency->Reset();
+    m_RunSyncLatency->Reset();
+}
+
+
+// Returns the number of pooled model instances that are not running an inference.
+int32 ANeuralNetwork::GetNumIdleModelInstances()
+{
+    int32 NumIdle = 0;
+
+    m_mutex.Lock();
+    for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+    {
+        if (!ModelHelper->bIsRunning)
+        {
+            NumIdle++;
+        }
+    }
+    m_mutex.Unlock();
+
+    return NumIdle;
+}
+
+
+int32 ANeuralNetwork::GetNumModelInstances() const
+{
+    return m_ModelHelperPool.Num();
+}
+
+
+// Running helpers are replaced rather than waited for, the request holding one finishes on it and drops the last reference.
+// Idle helpers can only be claimed on the game thread, so they are safe to reconfigure in place.
+bool ANeuralNetwork::SwapOutRunningModelHelpers()
+{
+    // Every caller changes the active instances by hand, so a prepared configuration owning them would no longer match
+    // its key and would keep the old pool and staging buffers
+    m_ShapeCache.RemoveAll([this](const TSharedPtr<FPreparedShapeConfig>& Config)
+        {
+            return Config->Pool[0] == m_ModelHelper;
+        });
+
+    for (TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+    {
+        if (!ModelHelper->bIsRunning)
+        {
+            continue;
+        }
+
+        TSharedPtr<FModelHelper> Replacement = MakeShared<FModelHelper>();
+        Replacement->Model = ModelHelper->Model;
+        Replacement->ModelInstance = ModelHelper->Model->CreateModelInstance();
+        if (!Replacement->ModelInstance.IsValid())
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to create a model instance to replace a running one"));
+            return false;
+        }
+
+        // Starts out configured like the helper it replaces, the caller then applies its change to the whole pool
+        if (!InputTensorShapes.IsEmpty() && Replacement->ModelInstance->SetInputTensorShapes(InputTensorShapes) != 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to set input tensor shapes on a replacement model instance"));
+            return false;
+        }
+        if (ModelHelper->InputBindings.Num() > 0)
+        {
+            Replacement->AllocateTensorArena(InputTensorShapes, ModelHelper->OutputShapes);
+        }
+
+        UE_LOG(LogNeuralNetwork, Verbose, TEXT("Replaced a running model instance for reconfiguration"));
+        ModelHelper = MoveTemp(Replacement);
+    }
+
+    m_ModelHelper = m_ModelHelperPool.Num() > 0 ? m_ModelHelperPool[0] : nullptr;
+    return true;
+}
+
+
+// Creates the executor on first use so InferenceThreads can still be changed after the actor is spawned.
+void ANeuralNetwork::LaunchWorkerJob(TUniqueFunction<void()> Job)
+{
+    if (InferenceThreads <= 0)
+    {
+        AsyncTask(ENamedThreads::AnyNormalThreadNormalTask, MoveTemp(Job));
+        return;
+    }
+
+    if (!m_Executor.IsValid())
+    {
+        EThreadPriority Priority = TPri_Normal;
+        switch (InferenceThreadPriority)
+        {
+        case ENNEThreadPriority::Lowest:
+            Priority = TPri_Lowest;
+            break;
+        case ENNEThreadPriority::BelowNormal:
+            Priority = TPri_BelowNormal;
+            break;
+        case ENNEThreadPriority::AboveNormal:
+            Priority = TPri_AboveNormal;
+            break;
+        default:
+            break;
+        }
+
+        m_Executor = MakeUnique<FNeuralNetworkExecutor>(InferenceThreads, Priority, static_cast<uint64>(InferenceAffinityMask));
+    }
+
+    m_Executor->Execute(MoveTemp(Job));
+}
+
+
+void ANeuralNetwork::GetExecutorStats(int32& NumWorkers, int32& QueueDepth, float& Utilization)
+{
+    NumWorkers = m_Executor.IsValid() ? m_Executor->GetNumWorkers() : 0;
+    QueueDepth = m_Executor.IsValid() ? m_Executor->GetQueueDepth() : 0;
+    Utilization = m_Executor.IsValid() ? m_Executor->SampleUtilization() : 0.0f;
+}
+
+
+// Picks the first free pooled model instance and marks it as running. Game thread only: it is the only thread that changes
+// the pool, and claiming an instance is a compare-exchange on its flag, so no lock is taken.
+TSharedPtr<FModelHelper> ANeuralNetwork::AcquireIdleModelHelper()
+{
+    for (const TSharedPtr<FModelHelper>& ModelHelper : m_ModelHelperPool)
+    {
+        if (ModelHelper->TryAcquire())
+        {
+            return ModelHelper;
+        }
+    }
+
+    return nullptr;
+}
+
+
+// Runs the model instance on a worker thread and sends the outputs to the completion delegates on the game thread.
+void ANeuralNetwork::DispatchInference(TSharedPtr<FModelHelper> ModelHelperPtr, FInferenceCompletion Completion, FExternalInputBinding ExternalInput)
+{
+    const double RequestTime = FPlatformTime::Seconds();
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> InferenceLatency = m_InferenceLatency;
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> RunSyncLatency = m_RunSyncLatency;
+    TSharedPtr<FEventRef, ESPMode::ThreadSafe> InstanceFreed = m_InstanceFreed;
+    TWeakObjectPtr<ANeuralNetwork> WeakThis(this);
+
+    UE_LOG(LogNeuralNetworkData, VeryVerbose, TEXT("Dispatching inference, %d inputs"), ModelHelperPtr->InputBindings.Num());
+
+    FRequestAbandonGuard AbandonGuard(Completion.Request);
+
+    LaunchWorkerJob([ModelHelperPtr, Completion = MoveTemp(Completion), ExternalInput = MoveTemp(ExternalInput), AbandonGuard = MoveTemp(AbandonGuard), RequestTime, InferenceLatency, RunSyncLatency, InstanceFreed, WeakThis]()
+        {
+            const double RunStarted = FPlatformTime::Seconds();
+            SET_FLOAT_STAT(STAT_NeuralNetwork_QueueWait, (RunStarted - RequestTime) * 1000.0);
+
+            // Staged and streamed requests read their first input straight from the caller's buffer
+            TArray<UE::NNE::FTensorBindingCPU, TInlineAllocator<4>> InputBindings(ModelHelperPtr->InputBindings);
+            if (ExternalInput.Data && InputBindings.Num() > 0)
+            {
+                InputBindings[0].Data = ExternalInput.Data;
+                InputBindings[0].SizeInBytes = ExternalInput.SizeInBytes;
+            }
+
+            bool bRunOk = true;
+            {
+                NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_RunSync);
+                if (ModelHelperPtr->ModelInstance->RunSync(InputBindings, ModelHelperPtr->OutputBindings) != 0)
+                {
+                    UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to run the model"));
+                    bRunOk = false;
+                }
+            }
+            RunSyncLatency->AddSample(FPlatformTime::Seconds() - RunStarted);
+
+            // Copy out before the instance is released, only what the bound delegates need. Outputs that are not float are widened once here.
+            TArray<float> CapturedOutputData;
+            TArray<FNNETensorData> CapturedOutputs;
+            FNNEClassificationResult Classification;
+            const bool bKeepOnRequest = Completion.Request.IsValid() && Completion.Request->KeepsOutputs();
+            // Nothing is read from the arena after a failed run, the delegates get empty outputs
+            if (bRunOk && (Completion.MultiResult.IsBound() || Completion.bStoreForReuse || bKeepOnRequest))
+            {
+                CapturedOutputs.SetNum(ModelHelperPtr->OutputBindings.Num());
+                for (int32 OutputIdx = 0; OutputIdx < CapturedOutputs.Num(); ++OutputIdx)
+                {
+                    TConstArrayView<float> OutputData = ModelHelperPtr->ReadOutput(OutputIdx);
+                    CapturedOutputs[OutputIdx].Data.Append(OutputData.GetData(), OutputData.Num());
+                    for (uint32 Dim : ModelHelperPtr->OutputShapes[OutputIdx].GetData())
+                    {
+                        CapturedOutputs[OutputIdx].Shape.Add(Dim);
+                    }
+                }
+            }
+            TConstArrayView<float> FirstOutput;
+            if (bRunOk && (Completion.Result.IsBound() || Completion.ClassificationResult.IsBound()))
+            {
+                FirstOutput = ModelHelperPtr->ReadOutput(0);
+            }
+            if (bRunOk && Completion.Result.IsBound())
+            {
+                CapturedOutputData.Append(FirstOutput.GetData(), FirstOutput.Num());
+            }
+            if (bRunOk && Completion.ClassificationResult.IsBound() && ModelHelperPtr->OutputShapes.Num() > 0)
+            {
+                if (!FNeuralNetworkPostProcessing::Process(FirstOutput, ModelHelperPtr->OutputShapes[0].GetData(), Completion.PostProcess, Classification))
+                {
+                    UE_LOG(LogNeuralNetwork, Error, TEXT("Post-processing settings do not fit the output shape"));
+                }
+            }
+
+            // Everything needed is copied out, the instance can take the next request while the results travel to the game thread
+            ReleaseModelHelper(*ModelHelperPtr, *InstanceFreed);
+
+            // Awaiting threads get the outputs here, without a trip through the game thread. A failed run finishes the token as dropped.
+            if (!bRunOk)
+            {
+                if (Completion.Request.IsValid())
+                {
+                    Completion.Request->Drop();
+                }
+            }
+            else if (!bKeepOnRequest)
+            {
+                if (Completion.Request.IsValid())
+                {
+                    Completion.Request->Complete(TArray<FNNETensorData>());
+                }
+            }
+            else if (Completion.MultiResult.IsBound() || Completion.bStoreForReuse)
+            {
+                Completion.Request->Complete(CapturedOutputs);
+            }
+            else
+            {
+                Completion.Request->Complete(MoveTemp(CapturedOutputs));
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Completion = MoveTempIfPossible(Completion), Release = MoveTempIfPossible(ExternalInput.Release), CapturedOutputData = MoveTempIfPossible(CapturedOutputData), CapturedOutputs = MoveTempIfPossible(CapturedOutputs), Classification = MoveTemp(Classification), bRunOk, RequestTime, InferenceLatency]()
+                {
+                    // End to end latency is measured up to the delegate, not including it
+                    const double Latency = FPlatformTime::Seconds() - RequestTime;
+                    InferenceLatency->AddSample(Latency);
+                    INC_DWORD_STAT(STAT_NeuralNetwork_InferencesCompleted);
+
+                    // Stored before the delegates run, so a request they submit can already reuse it. A failed run left the arena
+                    // as it was, caching that would serve it to every later matching input.
+                    if (Completion.bStoreForReuse && bRunOk)
+                    {
+                        if (ANeuralNetwork* This = WeakThis.Get())
+                        {
+                            This->StoreReusableResult(Completion, CapturedOutputs);
+                        }
+                    }
+
+                    {
+                        NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Callback);
+                        Completion.Result.ExecuteIfBound(CapturedOutputData);
+                        Completion.MultiResult.ExecuteIfBound(CapturedOutputs);
+                        Completion.ClassificationResult.ExecuteIfBound(Classification);
+                    }
+
+                    if (Release)
+                    {
+                        Release();
+                    }
+
+                    if (ANeuralNetwork* This = WeakThis.Get())
+                    {
+                        This->DrainPendingRequests();
+                    }
+
+                    UE_LOG(LogNeuralNetworkData, VeryVerbose, TEXT("Inference finished in %f s, %d outputs"), Latency, CapturedOutputData.Num());
+                    if (UE_LOG_ACTIVE(LogNeuralNetworkData, VeryVerbose))
+                    {
+                        for (float value : CapturedOutputData)
+                        {
+                            UE_LOG(LogNeuralNetworkData, VeryVerbose, TEXT("Prediction Value: %f"), value);
+                        }
+                    }
+                });
+        });
+}
+
+
+// Runs an asynchronous inference on the first free pooled model instance.
+FNNERequestHandle ANeuralNetwork::RunAsyncInference(bool InBSuccess, bool OutBSuccess, const TArray<float>& InputData, FNNEAsyncInferenceDelegate Result)
+{
+    FInferenceCompletion Completion;
+    Completion.Result = MoveTemp(Result);
+    FNNERequestHandle Handle = AttachRequest(Completion);
+    SubmitInference({ InputData }, MoveTemp(Completion));
+    return Handle;
+}
+
+
+// Runs an asynchronous inference whose first output is reduced to a class result on the worker thread.
+FNNERequestHandle ANeuralNetwork::RunAsyncClassification(const TArray<float>& InputData, FNNEAsyncClassificationDelegate Result)
+{
+    FInferenceCompletion Completion;
+    Completion.ClassificationResult = MoveTemp(Result);
+    Completion.PostProcess = PostProcessing;
+    FNNERequestHandle Handle = AttachRequest(Completion);
+    SubmitInference({ InputData }, MoveTemp(Completion));
+    return Handle;
+}
+
+
+// Runs an asynchronous inference with one input array per model input, every output is returned.
+FNNERequestHandle ANeuralNetwork::RunAsyncMultiInference(const TArray<FNNETensorData>& Inputs, FNNEAsyncMultiInferenceDelegate Result)
+{
+    FInferenceInputViews InputViews;
+    for (const FNNETensorData& Input : Inputs)
+    {
+        InputViews.Add(Input.Data);
+    }
+
+    FInferenceCompletion Completion;
+    Completion.MultiResult = MoveTemp(Result);
+    FNNERequestHandle Handle = AttachRequest(Completion);
+    SubmitInference(InputViews, MoveTemp(Completion));
+    return Handle;
+}
+
+
+FNNERequestHandle ANeuralNetwork::AttachRequest(FInferenceCompletion& Completion)
+{
+    FNNERequestHandle Handle;
+    Handle.Request = MakeShared<FNeuralNetworkRequest, ESPMode::ThreadSafe>(false);
+    Completion.Request = Handle.Request;
+    return Handle;
+}
+
+
+ENNERequestStatus ANeuralNetwork::GetRequestStatus(const FNNERequestHandle& Handle)
+{
+    return Handle.Request.IsValid() ? Handle.Request->GetStatus() : ENNERequestStatus::None;
+}
+
+
+int64 ANeuralNetwork::GetRequestId(const FNNERequestHandle& Handle)
+{
+    return Handle.Request.IsValid() ? Handle.Request->GetId() : 0;
+}
+
+
+bool ANeuralNetwork::CancelRequest(const FNNERequestHandle& Handle)
+{
+    return Handle.Request.IsValid() && Handle.Request->Cancel();
+}
+
+
+// The only part of the request path that runs off the game thread, one lock-free enqueue plus at most one scheduled drain.
+FNeuralNetworkRequestRef ANeuralNetwork::EnqueueInference(TArray<TArray<float>> Inputs)
+{
+    FNeuralNetworkRequestRef Request = MakeShared<FNeuralNetworkRequest, ESPMode::ThreadSafe>(true);
+
+    // Nothing would ever run it once the actor has ended play
+    if (m_bEndedPlay)
+    {
+        Request->Drop();
+        return Request;
+    }
+
+    FIncomingInferenceRequest Incoming;
+    Incoming.Inputs = MoveTemp(Inputs);
+    Incoming.Request = Request;
+    m_IncomingRequests.Enqueue(MoveTemp(Incoming));
+
+    if (!m_bIncomingDrainScheduled.exchange(true))
+    {
+        TWeakObjectPtr<ANeuralNetwork> WeakThis(this);
+        AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+            {
+                if (ANeuralNetwork* This = WeakThis.Get())
+                {
+                    This->DrainIncomingRequests();
+                }
+            });
+    }
+
+    return Request;
+}
+
+
+// The flag is cleared before dequeuing, a request enqueued after the last dequeue schedules a new drain.
+void ANeuralNetwork::DrainIncomingRequests()
+{
+    m_bIncomingDrainScheduled = false;
+
+    // A producer may have passed the EndPlay check just before it was set
+    if (m_bEndedPlay)
+    {
+        DropQueuedRequests();
+        return;
+    }
+
+    FIncomingInferenceRequest Incoming;
+    while (m_IncomingRequests.Dequeue(Incoming))
+    {
+        if (Incoming.Request->IsDone())
+        {
+            continue;
+        }
+
+        FInferenceInputViews InputViews;
+        for (const TArray<float>& Input : Incoming.Inputs)
+        {
+            InputViews.Add(Input);
+        }
+
+        FInferenceCompletion Completion;
+        Completion.Request = MoveTemp(Incoming.Request);
+        SubmitInference(InputViews, MoveTemp(Completion));
+    }
+}
+
+
+void ANeuralNetwork::DropQueuedRequests()
+{
+    FIncomingInferenceRequest Incoming;
+    while (m_IncomingRequests.Dequeue(Incoming))
+    {
+        Incoming.Request->Drop();
+    }
+
+    for (FPendingInferenceRequest& Pending : m_PendingRequests)
+    {
+        if (Pending.Completion.Request.IsValid())
+        {
+            Pending.Completion.Request->Drop();
+        }
+    }
+    m_PendingRequests.Reset();
+}
+
+
+// Earlier requests go first, a new request only runs straight away when nothing is pending.
+void ANeuralNetwork::SubmitInference(const FInferenceInputViews& Inputs, FInferenceCompletion Completion)
+{
+    // Finishes the token of a request that ends here without running
+    auto DropRequest = [](const FInferenceCompletion& Dropped)
+        {
+            if (Dropped.Request.IsValid())
+            {
+                Dropped.Request->Drop();
+            }
+        };
+
+    if (Completion.Request.IsValid() && Completion.Request->IsDone())
+    {
+        return;
+    }
+
+    if (!m_ModelHelper.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Model helper is not valid"));
+        DropRequest(Completion);
+        return;
+    }
+
+    if (!InputsMatchBindings(Inputs))
+    {
+        DropRequest(Completion);
+        return;
+    }
+
+    if (TryReuseResult(Inputs, Completion))
+    {
+        return;
+    }
+
+    DrainPendingRequests();
+    if (m_PendingRequests.IsEmpty() && TryDispatchInputs(Inputs, Completion))
+    {
+        return;
+    }
+
+    auto MakePending = [&Inputs, &Completion]()
+        {
+            FPendingInferenceRequest Request;
+            for (TConstArrayView<float> Input : Inputs)
+            {
+                Request.Inputs.Emplace(Input.GetData(), Input.Num());
+            }
+            Request.Completion = MoveTemp(Completion);
+            return Request;
+        };
+
+    switch (AdmissionPolicy)
+    {
+    case ENNEAdmissionPolicy::LatestWins:
+        m_NumReplaced += m_PendingRequests.Num();
+        INC_DWORD_STAT_BY(STAT_NeuralNetwork_RequestsReplaced, m_PendingRequests.Num());
+        for (const FPendingInferenceRequest& Replaced : m_PendingRequests)
+        {
+            DropRequest(Replaced.Completion);
+        }
+        m_PendingRequests.Reset();
+        m_PendingRequests.Add(MakePending());
+        m_NumQueued++;
+        INC_DWORD_STAT(STAT_NeuralNetwork_RequestsQueued);
+        break;
+
+    case ENNEAdmissionPolicy::BoundedQueue:
+        if (m_PendingRequests.Num() >= FMath::Max(1, MaxQueuedRequests))
+        {
+            DropRequest(m_PendingRequests[0].Completion);
+            m_PendingRequests.RemoveAt(0);
+            m_NumDropped++;
+            INC_DWORD_STAT(STAT_NeuralNetwork_RequestsDropped);
+        }
+        m_PendingRequests.Add(MakePending());
+        m_NumQueued++;
+        INC_DWORD_STAT(STAT_NeuralNetwork_RequestsQueued);
+        break;
+
+    case ENNEAdmissionPolicy::BlockUntilFree:
+    {
+        // Workers release instances themselves, so waiting here cannot starve the release
+        const double Deadline = FPlatformTime::Seconds() + MaxBlockTime;
+        while (!TryDispatchInputs(Inputs, Completion))
+        {
+            const double Remaining = Deadline - FPlatformTime::Seconds();
+            if (Remaining <= 0.0 || !(*m_InstanceFreed)->Wait(FTimespan::FromSeconds(Remaining)))
+            {
+                m_NumDropped++;
+                INC_DWORD_STAT(STAT_NeuralNetwork_RequestsDropped);
+                DropRequest(Completion);
+                UE_LOG(LogNeuralNetwork, Warning, TEXT("No model instance became free within %f s, request dropped"), MaxBlockTime);
+                break;
+            }
+        }
+        break;
+    }
+
+    default:
+        m_NumDropped++;
+        INC_DWORD_STAT(STAT_NeuralNetwork_RequestsDropped);
+        DropRequest(Completion);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("All %d model instances are already running"), m_ModelHelperPool.Num());
+        break;
+    }
+}
+
+
+// Claims a free instance and copies every input into its arena before dispatching.
+bool ANeuralNetwork::TryDispatchInputs(const FInferenceInputViews& Inputs, FInferenceCompletion& Completion)
+{
+    TSharedPtr<FModelHelper> ModelHelperPtr = AcquireIdleModelHelper();
+    if (!ModelHelperPtr.IsValid())
+    {
+        return false;
+    }
+
+    // A request cancelled while it waited counts as handled, the instance goes straight back to the pool
+    if (Completion.Request.IsValid() && !Completion.Request->TryStart())
+    {
+        ReleaseModelHelper(*ModelHelperPtr, **m_InstanceFreed);
+        return true;
+    }
+
+    // Copy in place, the input bindings point into the instance's tensor arena. Inputs of another type are converted on the way.
+    for (int32 InputIdx = 0; InputIdx < Inputs.Num(); ++InputIdx)
+    {
+        ModelHelperPtr->WriteInput(InputIdx, Inputs[InputIdx]);
+    }
+
+    if (Completion.bTemporalReference)
+    {
+        AdoptTemporalReference(Inputs[0], Completion);
+    }
+
+    DispatchInference(ModelHelperPtr, MoveTemp(Completion));
+    return true;
+}
+
+
+// Temporal skip is tried first since it needs no hash, identical inputs are matched by their 64-bit hash alone.
+bool ANeuralNetwork::TryReuseResult(const FInferenceInputViews& Inputs, FInferenceCompletion& Completion, TFunction<void()> Release)
+{
+    if ((!bCacheResults && !bTemporalSkip) || Inputs.Num() == 0)
+    {
+        return false;
+    }
+
+    m_NumReuseLookups++;
+    FReusableOutputs Reused;
+
+    const bool bTemporalCandidate = bTemporalSkip && Inputs.Num() == 1;
+    if (bTemporalCandidate && m_TemporalOutputs.IsValid() && m_TemporalOutputSeq == m_TemporalInputSeq && m_TemporalInput.Num() == Inputs[0].Num()
+        && (TemporalSkipMaxFrames <= 0 || m_ConsecutiveSkips < TemporalSkipMaxFrames))
+    {
+        // Summed in blocks the compiler vectorizes, stopping as soon as the frame is known to have changed
+        const int32 Num = Inputs[0].Num();
+        const float* New = Inputs[0].GetData();
+        const float* Old = m_TemporalInput.GetData();
+        const float MaxTotal = TemporalSkipThreshold * Num;
+        float Total = 0.0f;
+        for (int32 Start = 0; Start < Num && Total <= MaxTotal; Start += 1024)
+        {
+            const int32 End = FMath::Min(Start + 1024, Num);
+            for (int32 Idx = Start; Idx < End; ++Idx)
+            {
+                Total += FMath::Abs(New[Idx] - Old[Idx]);
+            }
+        }
+
+        if (Total <= MaxTotal)
+        {
+            Reused = m_TemporalOutputs;
+            m_ConsecutiveSkips++;
+            INC_DWORD_STAT(STAT_NeuralNetwork_TemporalSkips);
+        }
+    }
+
+    uint64 Key = 0;
+    if (!Reused.IsValid() && bCacheResults)
+    {
+        for (TConstArrayView<float> Input : Inputs)
+        {
+            Key = CityHash64WithSeed(reinterpret_cast<const char*>(Input.GetData()), Input.Num() * sizeof(float), Key);
+        }
+
+        const int32 CachedIdx = m_ResultCache.IndexOfByPredicate([Key](const FCachedResult& Cached) { return Cached.Key == Key; });
+        if (CachedIdx != INDEX_NONE)
+        {
+            FCachedResult Hit = m_ResultCache[CachedIdx];
+            m_ResultCache.RemoveAt(CachedIdx);
+            Reused = Hit.Outputs;
+            m_ResultCache.Add(MoveTemp(Hit));
+            INC_DWORD_STAT(STAT_NeuralNetwork_CacheHits);
+        }
+    }
+
+    if (!Reused.IsValid())
+    {
+        // The input only becomes the reference once the request is dispatched, a dropped or replaced request never gets outputs
+        Completion.bTemporalReference = bTemporalCandidate;
+        Completion.bStoreForReuse = true;
+        Completion.CacheKey = Key;
+        Completion.ReuseEpoch = m_ReuseEpoch;
+        return false;
+    }
+
+    m_NumReused++;
+
+    if (Completion.Request.IsValid())
+    {
+        // A cancelled request counts as handled, its delegates are never called
+        if (!Completion.Request->TryStart())
+        {
+            if (Release)
+            {
+                Release();
+            }
+            return true;
+        }
+        Completion.Request->Complete(Completion.Request->KeepsOutputs() ? *Reused : TArray<FNNETensorData>());
+    }
+
+    // Classification is reduced on a worker like a real result, the game thread only runs the delegates
+    if (!Completion.ClassificationResult.IsBound() || Reused->Num() == 0)
+    {
+        DeliverReusedResult(Reused, MoveTemp(Completion), MoveTemp(Release), FNNEClassificationResult());
+        return true;
+    }
+
+    LaunchWorkerJob([Reused, Completion = MoveTemp(Completion), Release = MoveTemp(Release)]() mutable
+        {
+            const FNNETensorData& FirstOutput = (*Reused)[0];
+            TArray<uint32> Shape;
+            for (int32 Dim : FirstOutput.Shape)
+            {
+                Shape.Add(Dim);
+            }
+
+            FNNEClassificationResult Classification;
+            if (!FNeuralNetworkPostProcessing::Process(FirstOutput.Data, Shape, Completion.PostProcess, Classification))
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Post-processing settings do not fit the output shape"));
+            }
+
+            DeliverReusedResult(Reused, MoveTemp(Completion), MoveTemp(Release), MoveTemp(Classification));
+        });
+
+    return true;
+}
+
+
+// Delivered on a later game thread task like a real result, never from inside the submitting call.
+void ANeuralNetwork::DeliverReusedResult(FReusableOutputs Reused, FInferenceCompletion Completion, TFunction<void()> Release, FNNEClassificationResult Classification)
+{
+    AsyncTask(ENamedThreads::GameThread, [Reused = MoveTemp(Reused), Completion = MoveTemp(Completion), Release = MoveTemp(Release), Classification = MoveTemp(Classification)]()
+        {
+            NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Callback);
+
+            const TArray<FNNETensorData>& Outputs = *Reused;
+            if (Outputs.Num() > 0)
+            {
+                Completion.Result.ExecuteIfBound(Outputs[0].Data);
+                Completion.ClassificationResult.ExecuteIfBound(Classification);
+            }
+            Completion.MultiResult.ExecuteIfBound(Outputs);
+
+            if (Release)
+            {
+                Release();
+            }
+        });
+}
+
+
+void ANeuralNetwork::AdoptTemporalReference(TConstArrayView<float> Input, FInferenceCompletion& Completion)
+{
+    m_TemporalInput.Reset();
+    m_TemporalInput.Append(Input.GetData(), Input.Num());
+    m_TemporalInputSeq++;
+    m_ConsecutiveSkips = 0;
+    Completion.TemporalSeq = m_TemporalInputSeq;
+}
+
+
+void ANeuralNetwork::StoreReusableResult(const FInferenceCompletion& Completion, const TArray<FNNETensorData>& Outputs)
+{
+    // Requests submitted before the last clear may have run on a previous model or configuration
+    if (Completion.ReuseEpoch != m_ReuseEpoch)
+    {
+        return;
+    }
+
+    FReusableOutputs Shared = MakeShared<TArray<FNNETensorData>, ESPMode::ThreadSafe>(Outputs);
+
+    if (bCacheResults && Completion.CacheKey != 0)
+    {
+        m_ResultCache.RemoveAll([&Completion](const FCachedResult& Cached) { return Cached.Key == Completion.CacheKey; });
+        while (m_ResultCache.Num() >= FMath::Max(1, ResultCacheSize))
+        {
+            m_ResultCache.RemoveAt(0);
+        }
+
+        FCachedResult& Cached = m_ResultCache.AddDefaulted_GetRef();
+        Cached.Key = Completion.CacheKey;
+        Cached.Outputs = Shared;
+    }
+
+    // Only outputs of the current reference input may be reused for frames similar to it
+    if (Completion.TemporalSeq != 0 && Completion.TemporalSeq == m_TemporalInputSeq)
+    {
+        m_TemporalOutputs = Shared;
+        m_TemporalOutputSeq = Completion.TemporalSeq;
+    }
+}
+
+
+void ANeuralNetwork::GetResultReuseStats(float& HitRate, int32& InferencesAvoided, int32& NumLookups)
+{
+    HitRate = m_NumReuseLookups > 0 ? static_cast<float>(m_NumReused) / m_NumReuseLookups : 0.0f;
+    InferencesAvoided = m_NumReused;
+    NumLookups = m_NumReuseLookups;
+}
+
+
+void ANeuralNetwork::ClearResultCache()
+{
+    m_ResultCache.Reset();
+    m_TemporalInput.Reset();
+    m_TemporalOutputs.Reset();
+    m_TemporalInputSeq++;
+    m_ReuseEpoch++;
+    m_ConsecutiveSkips = 0;
+    m_NumReuseLookups = 0;
+    m_NumReused = 0;
+}
+
+
+// Pending requests whose inputs no longer fit, e.g. after ActivateInputShape, are dropped instead of dispatched.
+void ANeuralNetwork::DrainPendingRequests()
+{
+    while (m_PendingRequests.Num() > 0)
+    {
+        FPendingInferenceRequest& Request = m_PendingRequests[0];
+        if (Request.Completion.Request.IsValid() && Request.Completion.Request->IsDone())
+        {
+            m_PendingRequests.RemoveAt(0);
+            continue;
+        }
+
+        FInferenceInputViews InputViews;
+        for (const TArray<float>& Input : Request.Inputs)
+        {
+            InputViews.Add(Input);
+        }
+
+        if (!InputsMatchBindings(InputViews))
+        {
+            m_NumDropped++;
+            INC_DWORD_STAT(STAT_NeuralNetwork_RequestsDropped);
+            if (Request.Completion.Request.IsValid())
+            {
+                Request.Completion.Request->Drop();
+            }
+        }
+        else if (!TryDispatchInputs(InputViews, Request.Completion))
+        {
+            return;
+        }
+
+        m_PendingRequests.RemoveAt(0);
+    }
+}
+
+
+bool ANeuralNetwork::InputsMatchBindings(const FInferenceInputViews& Inputs) const
+{
+    if (!m_ModelHelper.IsValid() || Inputs.Num() != m_ModelHelper->InputBindings.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Got %d inputs, the model expects %d"), Inputs.Num(), m_ModelHelper.IsValid() ? m_ModelHelper->InputBindings.Num() : 0);
+        return false;
+    }
+
+    for (int32 InputIdx = 0; InputIdx < Inputs.Num(); ++InputIdx)
+    {
+        const int32 BindingLength = m_ModelHelper->GetInputNum(InputIdx);
+        if (Inputs[InputIdx].Num() != BindingLength)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Input %d length %d does not match the input binding length %d"), InputIdx, Inputs[InputIdx].Num(), BindingLength);
+            return false;
+        }
+        if (!FNeuralNetworkTensorTypes::IsConvertible(m_ModelHelper->InputDataTypes[InputIdx]))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Input %d has an element type that float values cannot be converted to"), InputIdx);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void ANeuralNetwork::GetAdmissionStats(int32& NumQueued, int32& NumReplaced, int32& NumDropped, int32& NumPending)
+{
+    NumQueued = m_NumQueued;
+    NumReplaced = m_NumReplaced;
+    NumDropped = m_NumDropped;
+    NumPending = m_PendingRequests.Num();
+}
+
+
+void ANeuralNetwork::ResetAdmissionStats()
+{
+    m_NumQueued = 0;
+    m_NumReplaced = 0;
+    m_NumDropped = 0;
+}
+
+
+// Hands out a free persistent input buffer for the caller to fill in place.
+TArrayView<float> ANeuralNetwork::BeginInputStaging(int32& OutStagingIdx)
+{
+    OutStagingIdx = INDEX_NONE;
+
+    if (m_InputStaging.Num() > 0 && m_InputStaging[0]->DataType != ENNETensorDataType::Float)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("BeginInputStaging hands out float buffers but the model input is not float, use PreProcessImageToStaging or RunAsyncInference"));
+        return TArrayView<float>();
+    }
+
+    FInputStagingBuffer* StagingBuffer = AcquireInputStaging(OutStagingIdx);
+    return StagingBuffer ? StagingBuffer->GetView<float>() : TArrayView<float>();
+}
+
+
+FInputStagingBuffer* ANeuralNetwork::AcquireInputStaging(int32& OutStagingIdx)
+{
+    OutStagingIdx = INDEX_NONE;
+
+    for (int32 StagingIdx = 0; StagingIdx < m_InputStaging.Num(); ++StagingIdx)
+    {
+        FInputStagingBuffer& StagingBuffer = *m_InputStaging[StagingIdx];
+        if (!StagingBuffer.bInUse)
+        {
+            StagingBuffer.bInUse = true;
+            OutStagingIdx = StagingIdx;
+            return &StagingBuffer;
+        }
+    }
+
+    return nullptr;
+}
+
+
+// Runs inference with the input binding pointing straight at the staging buffer, no copy of the input is made.
+bool ANeuralNetwork::SubmitStagedInference(int32 StagingIdx, FNNEAsyncInferenceDelegate Result)
+{
+    FInferenceCompletion Completion;
+    Completion.Result = MoveTemp(Result);
+    return SubmitStaged(StagingIdx, Completion);
+}
+
+
+// The input binding is pointed at the staging buffer, which is released once the result is delivered.
+bool ANeuralNetwork::SubmitStaged(int32 StagingIdx, FInferenceCompletion& Completion)
+{
+    if (!m_InputStaging.IsValidIndex(StagingIdx) || !m_InputStaging[StagingIdx]->bInUse)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Invalid staging buffer %d"), StagingIdx);
+        return false;
+    }
+
+    TSharedPtr<FInputStagingBuffer> StagingBuffer = m_InputStaging[StagingIdx];
+
+    // Claimed before the reuse lookup, a frame retried every tick while all instances are busy would count as a lookup each time
+    TSharedPtr<FModelHelper> ModelHelperPtr = AcquireIdleModelHelper();
+
+    if (!ModelHelperPtr.IsValid())
+    {
+        // The staging buffer stays reserved so the caller can submit it again
+        return false;
+    }
+
+    // Float buffers of single input models can be served without running the model
+    if ((bCacheResults || bTemporalSkip) && StagingBuffer->DataType == ENNETensorDataType::Float && ModelHelperPtr->InputBindings.Num() == 1)
+    {
+        FInferenceInputViews Inputs;
+        Inputs.Add(StagingBuffer->GetView<float>());
+        if (TryReuseResult(Inputs, Completion, [StagingBuffer]() { StagingBuffer->bInUse = false; }))
+        {
+            ReleaseModelHelper(*ModelHelperPtr, **m_InstanceFreed);
+            return true;
+        }
+    }
+
+    FExternalInputBinding ExternalInput;
+    ExternalInput.Data = StagingBuffer->Data.GetData();
+    ExternalInput.SizeInBytes = StagingBuffer->Data.Num();
+    ExternalInput.Release = [StagingBuffer]()
+        {
+            StagingBuffer->bInUse = false;
+        };
+
+    if (Completion.bTemporalReference)
+    {
+        AdoptTemporalReference(StagingBuffer->GetView<float>(), Completion);
+    }
+
+    DispatchInference(ModelHelperPtr, MoveTemp(Completion), MoveTemp(ExternalInput));
+
+    return true;
+}
+
+
+// Returns a staging buffer to the free list.
+void ANeuralNetwork::CancelInputStaging(int32 StagingIdx)
+{
+    if (m_InputStaging.IsValidIndex(StagingIdx))
+    {
+        m_InputStaging[StagingIdx]->bInUse = false;
+    }
+}
+
+
+// Validates the pipeline once up front so Tick only has to run it.
+bool ANeuralNetwork::StartContinuousInference(UTextureRenderTarget2D* InputRT)
+{
+    if (InputRT)
+    {
+        SetCaptureRenderTarget(InputRT);
+    }
+
+    if (!m_CaptureSource.IsValid() || m_InputStaging.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Continuous inference needs a capture source and the input bindings, call CreateInputTensorBinding first"));
+        return false;
+    }
+
+    m_bContinuousActive = true;
+    m_ContinuousStagingIdx = INDEX_NONE;
+    m_FramesSinceCapture = ContinuousFrameInterval;
+    m_LastCaptureTime = 0.0;
+    m_ContinuousIntervalScale = 1.0f;
+    m_ContinuousAverageMs = 0.0f;
+    m_NumContinuousSubmitted = 0;
+
+    return true;
+}
+
+
+void ANeuralNetwork::StopContinuousInference()
+{
+    m_bContinuousActive = false;
+
+    if (m_ContinuousStagingIdx != INDEX_NONE)
+    {
+        CancelInputStaging(m_ContinuousStagingIdx);
+        m_ContinuousStagingIdx = INDEX_NONE;
+    }
+}
+
+
+void ANeuralNetwork::GetContinuousStats(float& IntervalScale, float& AverageGameThreadMs, int32& NumSubmitted)
+{
+    IntervalScale = m_ContinuousIntervalScale;
+    AverageGameThreadMs = m_ContinuousAverageMs;
+    NumSubmitted = m_NumContinuousSubmitted;
+}
+
+
+// Submits the last preprocessed frame, turns a finished capture into the next one and starts a new capture when due,
+// then stretches or relaxes the intervals according to the game thread time spent.
+void ANeuralNetwork::TickContinuousInference()
+{
+    if (!m_bContinuousActive || !m_CaptureSource.IsValid())
+    {
+        return;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_ContinuousTick);
+    const double Started = FPlatformTime::Seconds();
+
+    // A finished capture is only taken once the previous frame left its staging buffer.
+    // With dedicated inference threads the frame is preprocessed on the executor and staged once that job is done.
+    int32 CaptureHeight = 0;
+    int32 CaptureWidth = 0;
+    if (m_ContinuousStagingIdx == INDEX_NONE && !m_bContinuousPreProcessing && TryGetCapture(m_ContinuousPixels, CaptureHeight, CaptureWidth))
+    {
+        if (InferenceThreads > 0)
+        {
+            PreProcessContinuousFrame(CaptureHeight, CaptureWidth);
+        }
+        else if (!PreProcessImageToStaging(m_ContinuousPixels, CaptureHeight, CaptureWidth, m_ContinuousStagingIdx))
+        {
+            m_ContinuousStagingIdx = INDEX_NONE;
+        }
+    }
+
+    if (m_ContinuousStagingIdx != INDEX_NONE)
+    {
+        FInferenceCompletion Completion;
+        if (OnContinuousOutput.IsBound())
+        {
+            Completion.Result.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ANeuralNetwork, HandleContinuousOutput));
+        }
+        if (OnContinuousClassification.IsBound())
+        {
+            Completion.ClassificationResult.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ANeuralNetwork, HandleContinuousClassification));
+            Completion.PostProcess = PostProcessing;
+        }
+
+        // Keep the frame for the next tick while every instance is busy
+        if (SubmitStaged(m_ContinuousStagingIdx, Completion))
+        {
+            m_ContinuousStagingIdx = INDEX_NONE;
+            m_NumContinuousSubmitted++;
+        }
+    }
+
+    // Only capture when the frame could be used, a frame still waiting for an instance would make the capture stale.
+    // Captures overlap as long as the readback ring has a free slot. The frame interval counts as at least one frame
+    // so the budget scale can still skip frames when both intervals are left at 0.
+    m_FramesSinceCapture++;
+    const double Now = FPlatformTime::Seconds();
+    const bool bFrameDue = m_FramesSinceCapture >= FMath::CeilToInt32(FMath::Max(1, ContinuousFrameInterval) * m_ContinuousIntervalScale);
+    const bool bTimeDue = Now - m_LastCaptureTime >= ContinuousTimeInterval * m_ContinuousIntervalScale;
+    if (bFrameDue && bTimeDue && m_ContinuousStagingIdx == INDEX_NONE && m_CaptureSource->HasFreeCaptureSlot())
+    {
+        if (RequestCapture())
+        {
+            m_FramesSinceCapture = 0;
+            m_LastCaptureTime = Now;
+        }
+    }
+
+    const float SpentMs = static_cast<float>((FPlatformTime::Seconds() - Started) * 1000.0);
+    m_ContinuousAverageMs = FMath::Lerp(m_ContinuousAverageMs, SpentMs, 0.1f);
+
+    if (SpentMs > ContinuousBudgetMs)
+    {
+        m_ContinuousIntervalScale = FMath::Min(m_ContinuousIntervalScale * 1.5f, 16.0f);
+    }
+    else if (m_ContinuousAverageMs < 0.5f * ContinuousBudgetMs)
+    {
+        m_ContinuousIntervalScale = FMath::Max(m_ContinuousIntervalScale * 0.95f, 1.0f);
+    }
+}
+
+
+// The capture buffer travels with the job and comes back with the result, so its allocation is still reused.
+void ANeuralNetwork::PreProcessContinuousFrame(int32 CaptureHeight, int32 CaptureWidth)
+{
+    FNNEImageNormalization Normalization;
+    int32 Height = 0;
+    int32 Width = 0;
+    int32 StagingIdx = INDEX_NONE;
+    if (!AcquireImageStaging(Normalization, Height, Width, StagingIdx))
+    {
+        return;
+    }
+
+    TSharedPtr<FInputStagingBuffer> StagingBuffer = m_InputStaging[StagingIdx];
+    const ENNEResizeFilter Filter = ResizeFilter;
+    TWeakObjectPtr<ANeuralNetwork> WeakThis(this);
+    m_bContinuousPreProcessing = true;
+
+    LaunchWorkerJob([WeakThis, Pixels = MoveTemp(m_ContinuousPixels), StagingBuffer, StagingIdx, CaptureHeight, CaptureWidth, Height, Width, Filter, Normalization]() mutable
+        {
+            const bool bSuccess = PixelsToTypedTensor(Pixels, CaptureWidth, CaptureHeight, Width, Height, Filter, Normalization, StagingBuffer->Data.GetData(), StagingBuffer->DataType, StagingBuffer->Num);
+            if (!bSuccess)
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("PreProcessImageToStaging failed for %dx%d to %dx%dx%d"), CaptureWidth, CaptureHeight, Width, Height, Normalization.ColorChannels);
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Pixels = MoveTemp(Pixels), StagingBuffer, StagingIdx, bSuccess]() mutable
+                {
+                    ANeuralNetwork* This = WeakThis.Get();
+                    if (!This)
+                    {
+                        return;
+                    }
+
+                    This->m_bContinuousPreProcessing = false;
+                    This->m_ContinuousPixels = MoveTemp(Pixels);
+
+                    // A rebind replaces the staging buffers, the frame then belongs to none of them and is dropped
+                    if (!This->m_InputStaging.IsValidIndex(StagingIdx) || This->m_InputStaging[StagingIdx] != StagingBuffer)
+                    {
+                        return;
+                    }
+
+                    if (bSuccess && This->m_bContinuousActive && This->m_ContinuousStagingIdx == INDEX_NONE)
+                    {
+                        This->m_ContinuousStagingIdx = StagingIdx;
+                    }
+                    else
+                    {
+                        This->CancelInputStaging(StagingIdx);
+                    }
+                });
+        });
+}
+
+
+void ANeuralNetwork::HandleContinuousOutput(const TArray<float>& OutData)
+{
+    OnContinuousOutput.Broadcast(OutData);
+}
+
+
+void ANeuralNetwork::HandleContinuousClassification(const FNNEClassificationResult& Result)
+{
+    OnContinuousClassification.Broadcast(Result);
+}
+
+
+// Sizes the frame ring from the rank 5 input shape, one ring slot holds one preprocessed [C, H, W] frame.
+bool ANeuralNetwork::BeginClipStreaming()
+{
+    m_ClipBuffer.Reset();
+
+    if (InputTensorShapes.Num() == 0 || InputTensorShapes[0].Rank() != 5 || InputTensorShapes[0].GetData()[0] != 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Clip streaming needs a [1, Frame, C, H, W] input tensor shape"));
+        return false;
+    }
+
+    if (InputTensorDescs.Num() == 0 || InputTensorDescs[0].GetDataType() != ENNETensorDataType::Float)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Clip streaming needs a float input tensor"));
+        return false;
+    }
+
+    // The per frame shape is the clip shape without its frame dimension
+    TConstArrayView<uint32> ClipShape = InputTensorShapes[0].GetData();
+    const uint32 FrameShape[] = { ClipShape[0], ClipShape[2], ClipShape[3], ClipShape[4] };
+
+    m_ClipNormalization = InputNormalization;
+    if (!FNeuralNetworkPreProcessing::DescribeImageShape(MakeArrayView(FrameShape), m_ClipNormalization.Layout, m_ClipNormalization.ColorChannels, m_ClipFrameHeight, m_ClipFrameWidth))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Clip streaming could not find a 1 or 3 channel image in the frame shape"));
+        return false;
+    }
+
+    const int32 NumFrames = ClipShape[1];
+    const int32 FrameVolume = InputTensorShapes[0].Volume() / NumFrames;
+    m_ClipBuffer = MakeShared<FNeuralNetworkClipBuffer>(NumFrames, FrameVolume, NumClipSpareFrames);
+
+    return true;
+}
+
+
+// Preprocesses straight into the next ring slot, the clip itself is never rebuilt.
+bool ANeuralNetwork::PushClipFrame(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth)
+{
+    if (!m_ClipBuffer.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PushClipFrame needs BeginClipStreaming first"));
+        return false;
+    }
+
+    TArrayView<float> Frame = m_ClipBuffer->BeginFrame();
+    if (Frame.Num() == 0)
+    {
+        return false;
+    }
+
+    if (!FNeuralNetworkPreProcessing::PixelsToTensor(ImagePixelBuffer, OriginalWidth, OriginalHeight, m_ClipFrameWidth, m_ClipFrameHeight, ResizeFilter, m_ClipNormalization, Frame))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PushClipFrame failed for %dx%d to %dx%dx%d"), OriginalWidth, OriginalHeight, m_ClipFrameWidth, m_ClipFrameHeight, m_ClipNormalization.ColorChannels);
+        return false;
+    }
+
+    m_ClipBuffer->CommitFrame();
+    return true;
+}
+
+
+// Binds the newest window of the ring as the input, its slots stay pinned until the result is delivered.
+bool ANeuralNetwork::RunAsyncClipInference(FNNEAsyncInferenceDelegate Result)
+{
+    if (!m_ClipBuffer.IsValid() || !m_ClipBuffer->IsWindowReady())
+    {
+        return false;
+    }
+
+    TSharedPtr<FModelHelper> ModelHelperPtr = AcquireIdleModelHelper();
+
+    if (!ModelHelperPtr.IsValid())
+    {
+        return false;
+    }
+
+    TArrayView<float> Window;
+    const int32 FirstSlot = m_ClipBuffer->AcquireWindow(Window);
 
-    if (m_ModelHelper.IsValid())
+    FExternalInputBinding ExternalInput;
+    ExternalInput.Data = Window.GetData();
+    ExternalInput.SizeInBytes = Window.Num() * sizeof(float);
+    ExternalInput.Release = [ClipBuffer = m_ClipBuffer, FirstSlot]()
+        {
+            ClipBuffer->ReleaseWindow(FirstSlot);
+        };
+
+    FInferenceCompletion Completion;
+    Completion.Result = MoveTemp(Result);
+    DispatchInference(ModelHelperPtr, MoveTemp(Completion), MoveTemp(ExternalInput));
+
+    return true;
+}
+
+
+// Claims every idle instance once, then one worker job per instance pulls tiles from an atomic tile counter.
+// Each instance crops, preprocesses, runs and reduces its tiles in its own arena, so nothing is shared between tiles.
+bool ANeuralNetwork::RunAsyncTiledInference(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, FNNEAsyncTiledInferenceDelegate Result)
+{
+    if (InputTensorShapes.Num() != 1 || InputTensorShapes[0].Rank() != 4 || OutputTensorShapes.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Tiled inference needs a model with a single rank 4 image input"));
+        return false;
+    }
+    // The workers read the instance's bindings and output shapes, which only exist once both bindings were created
+    if (!m_ModelHelper.IsValid() || m_ModelHelper->InputBindings.Num() == 0 || m_ModelHelper->OutputShapes.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Tiled inference needs the tensor bindings, call CreateInputTensorBinding and CreateOutputTensorBinding first"));
+        return false;
+    }
+    if (OriginalHeight <= 0 || OriginalWidth <= 0 || ImagePixelBuffer.Num() < OriginalHeight * OriginalWidth)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Tiled inference got %d pixels for a %dx%d image"), ImagePixelBuffer.Num(), OriginalWidth, OriginalHeight);
+        return false;
+    }
+
+    FNNEImageNormalization Normalization = InputNormalization;
+    int32 ModelHeight = 0;
+    int32 ModelWidth = 0;
+    if (!FNeuralNetworkPreProcessing::DescribeImageShape(InputTensorShapes[0].GetData(), Normalization.Layout, Normalization.ColorChannels, ModelHeight, ModelWidth))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Tiled inference could not find a 1 or 3 channel image in the input tensor shape"));
+        return false;
+    }
+
+    FNNETiledResult Tiled;
+    Tiled.TileSize.X = FMath::Clamp(FMath::RoundToInt32(ModelWidth * TileSourceScale), 1, OriginalWidth);
+    Tiled.TileSize.Y = FMath::Clamp(FMath::RoundToInt32(ModelHeight * TileSourceScale), 1, OriginalHeight);
+
+    TArray<int32> OriginsX;
+    TArray<int32> OriginsY;
+    ComputeTileOrigins(OriginalWidth, Tiled.TileSize.X, FMath::Clamp(TileOverlap, 0.0f, 0.9f), OriginsX);
+    ComputeTileOrigins(OriginalHeight, Tiled.TileSize.Y, FMath::Clamp(TileOverlap, 0.0f, 0.9f), OriginsY);
+
+    Tiled.TilesX = OriginsX.Num();
+    Tiled.TilesY = OriginsY.Num();
+    for (int32 OriginY : OriginsY)
+    {
+        for (int32 OriginX : OriginsX)
+        {
+            Tiled.TileOrigins.Add(FIntPoint(OriginX, OriginY));
+        }
+    }
+    Tiled.ScoreMap.SetNumZeroed(Tiled.TileOrigins.Num());
+    Tiled.ClassMap.Init(INDEX_NONE, Tiled.TileOrigins.Num());
+
+    // Instances are claimed once up front, the tiles themselves never touch the pool
+    TArray<TSharedPtr<FModelHelper>> Helpers;
+    while (Helpers.Num() < Tiled.TileOrigins.Num())
     {
-        // Example for async inference
-        if (!m_ModelHelper->bIsRunning)
+        TSharedPtr<FModelHelper> ModelHelperPtr = AcquireIdleModelHelper();
+        if (!ModelHelperPtr.IsValid())
         {
-            m_mutex.Lock();
+            break;
+        }
+        Helpers.Add(MoveTemp(ModelHelperPtr));
+    }
 
-            UE_LOG(LogTemp, Error, TEXT("Model is locked"));
+    if (Helpers.Num() == 0)
+    {
+        return false;
+    }
 
-            m_ModelHelper->InputData = InputData;
-            UE_LOG(LogTemp, Error, TEXT("InputData Length Loaded: %d"), m_ModelHelper->InputData.Num());
+    // Every tile is reduced to its single best class
+    TSharedRef<FTiledInferenceJob, ESPMode::ThreadSafe> Job = MakeShared<FTiledInferenceJob, ESPMode::ThreadSafe>();
+    Job->Pixels = ImagePixelBuffer;
+    Job->OriginalWidth = OriginalWidth;
+    Job->ModelHeight = ModelHeight;
+    Job->ModelWidth = ModelWidth;
+    Job->Normalization = Normalization;
+    Job->Settings = PostProcessing;
+    Job->Settings.TopK = 1;
+    Job->Settings.bPerLocation = false;
+    Job->Filter = ResizeFilter;
+    Job->Tiled = MoveTemp(Tiled);
+    Job->Result = MoveTemp(Result);
+    Job->RemainingWorkers = Helpers.Num();
+
+    const double RequestTime = FPlatformTime::Seconds();
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> InferenceLatency = m_InferenceLatency;
+    TSharedPtr<FEventRef, ESPMode::ThreadSafe> InstanceFreed = m_InstanceFreed;
+    TWeakObjectPtr<ANeuralNetwork> WeakThis(this);
+
+    // One job per claimed instance, each pulls tiles until none are left and the last one to finish delivers the map
+    for (TSharedPtr<FModelHelper>& ModelHelperPtr : Helpers)
+    {
+        LaunchWorkerJob([Job, ModelHelperPtr = MoveTemp(ModelHelperPtr), RequestTime, InferenceLatency, InstanceFreed, WeakThis]()
+            {
+                TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_TiledInference);
 
-            m_ModelHelper->bIsRunning = true;
-            IsModelRunning = true;
-            UE_LOG(LogTemp, Error, TEXT("Model is running"));
+                FModelHelper& ModelHelper = *ModelHelperPtr;
+                const int32 NumTiles = Job->Tiled.TileOrigins.Num();
+                const FIntPoint TileSize = Job->Tiled.TileSize;
 
-            TSharedPtr<FModelHelper> ModelHelperPtr = m_ModelHelper;
-            UE_LOG(LogTemp, Error, TEXT("Model Helper Ptr loaded, beginning async task..."));
+                TArray<FColor> TilePixels;
+                TilePixels.SetNumUninitialized(TileSize.X * TileSize.Y);
 
-            AsyncTask(ENamedThreads::AnyNormalThreadNormalTask, [ModelHelperPtr, Result = MoveTempIfPossible(Result)]()
+                for (int32 TileIdx = Job->NextTile++; TileIdx < NumTiles; TileIdx = Job->NextTile++)
                 {
-                    if (ModelHelperPtr->ModelInstance->RunSync(ModelHelperPtr->InputBindings, ModelHelperPtr->OutputBindings) != 0)
+                    const FIntPoint Origin = Job->Tiled.TileOrigins[TileIdx];
+                    for (int32 Row = 0; Row < TileSize.Y; ++Row)
+                    {
+                        FMemory::Memcpy(TilePixels.GetData() + Row * TileSize.X, Job->Pixels.GetData() + (Origin.Y + Row) * Job->OriginalWidth + Origin.X, TileSize.X * sizeof(FColor));
+                    }
+
+                    if (!PixelsToTypedTensor(TilePixels, TileSize.X, TileSize.Y, Job->ModelWidth, Job->ModelHeight, Job->Filter, Job->Normalization, ModelHelper.InputBindings[0].Data, ModelHelper.InputDataTypes[0], ModelHelper.GetInputNum(0)))
+                    {
+                        continue;
+                    }
+
+                    {
+                        NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_RunSync);
+                        if (ModelHelper.ModelInstance->RunSync(ModelHelper.InputBindings, ModelHelper.OutputBindings) != 0)
+                        {
+                            UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to run the model on tile %d"), TileIdx);
+                            continue;
+                        }
+                    }
+
+                    // Each tile writes only its own map entries
+                    FNNEClassificationResult TileResult;
+                    if (FNeuralNetworkPostProcessing::Process(ModelHelper.ReadOutput(0), ModelHelper.OutputShapes[0].GetData(), Job->Settings, TileResult) && TileResult.ClassIndices.Num() > 0)
                     {
-                        UE_LOG(LogTemp, Error, TEXT("Failed to run the model"));
+                        Job->Tiled.ClassMap[TileIdx] = TileResult.ClassIndices[0];
+                        Job->Tiled.ScoreMap[TileIdx] = TileResult.Scores[0];
                     }
+                }
+
+                ReleaseModelHelper(ModelHelper, *InstanceFreed);
+
+                if (--Job->RemainingWorkers > 0)
+                {
+                    return;
+                }
 
-                    TArray<float> CapturedOutputData = ModelHelperPtr->OutputData;
-                    UE_LOG(LogTemp, Error, TEXT("Inference finished, Captured Data Length: %d"), CapturedOutputData.Num());
+                AsyncTask(ENamedThreads::GameThread, [Job, RequestTime, InferenceLatency, WeakThis]()
+                    {
+                        InferenceLatency->AddSample(FPlatformTime::Seconds() - RequestTime);
+                        INC_DWORD_STAT(STAT_NeuralNetwork_InferencesCompleted);
 
-                    AsyncTask(ENamedThreads::GameThread, [ModelHelperPtr = MoveTempIfPossible(ModelHelperPtr), Result = MoveTempIfPossible(Result), CapturedOutputData = MoveTempIfPossible(CapturedOutputData)]()
                         {
-                            UE_LOG(LogTemp, Error, TEXT("Sending to delegate, Captured Data Length: %d"), CapturedOutputData.Num());
-                            Result.ExecuteIfBound(CapturedOutputData);
-                            ModelHelperPtr->bIsRunning = false;
-                            
-                            UE_LOG(LogTemp, Error, TEXT("Model is now off, Captured Data Length: %d"), CapturedOutputData.Num());
-                            for (float value : CapturedOutputData)
-                            {
-                                UE_LOG(LogTemp, Warning, TEXT("Prediction Value: %f"), value);
-                            }
-                        });
-                });
-            m_mutex.Unlock();
-            IsModelRunning = false;
-            UE_LOG(LogTemp, Error, TEXT("Model Unlocked"));
+                            NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Callback);
+                            Job->Result.ExecuteIfBound(Job->Tiled);
+                        }
+
+                        if (ANeuralNetwork* This = WeakThis.Get())
+                        {
+                            This->DrainPendingRequests();
+                        }
+                    });
+            });
+    }
+
+    return true;
+}
+
+
+// Model stages claim their instances here on the game thread, the worker then runs every stage without going back to it.
+// Model outputs are read in place from the claimed arenas and bound directly as the next model's input, so only glue ops write
+// new buffers. Every claimed instance stays reserved until the whole cascade is done, as later stages may read its output.
+bool ANeuralNetwork::RunAsyncCascade(const FNNETensorData& Input, const TArray<FNNECascadeStage>& Stages, FNNEAsyncInferenceDelegate Result)
+{
+    if (Stages.Num() == 0 || Input.Data.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("A cascade needs an input and at least one stage"));
+        return false;
+    }
+
+    TArray<TSharedPtr<FModelHelper>> Helpers;
+    TArray<TSharedPtr<FEventRef, ESPMode::ThreadSafe>> InstanceFreed;
+    TArray<TWeakObjectPtr<ANeuralNetwork>> Networks;
+    Helpers.SetNum(Stages.Num());
+    InstanceFreed.SetNum(Stages.Num());
+
+    auto ReleaseHelpers = [](const TArray<TSharedPtr<FModelHelper>>& InHelpers, const TArray<TSharedPtr<FEventRef, ESPMode::ThreadSafe>>& InInstanceFreed)
+        {
+            for (int32 StageIdx = 0; StageIdx < InHelpers.Num(); ++StageIdx)
+            {
+                if (InHelpers[StageIdx].IsValid())
+                {
+                    ReleaseModelHelper(*InHelpers[StageIdx], *InInstanceFreed[StageIdx]);
+                }
+            }
+        };
+
+    for (int32 StageIdx = 0; StageIdx < Stages.Num(); ++StageIdx)
+    {
+        const FNNECascadeStage& Stage = Stages[StageIdx];
+        if (Stage.Source < -1 || Stage.Source > StageIdx)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Cascade stage %d reads tensor %d, which is not available yet"), StageIdx, Stage.Source);
+            ReleaseHelpers(Helpers, InstanceFreed);
+            return false;
         }
-        else
+
+        if (Stage.Op != ENNECascadeOp::Model)
+        {
+            continue;
+        }
+
+        ANeuralNetwork* Network = Stage.Network ? Stage.Network.Get() : this;
+        const TSharedPtr<FModelHelper>& ActiveHelper = Network->m_ModelHelper;
+        if (!ActiveHelper.IsValid() || ActiveHelper->InputBindings.Num() != 1 || ActiveHelper->OutputBindings.Num() == 0 || !FNeuralNetworkTensorTypes::IsConvertible(ActiveHelper->InputDataTypes[0]))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Cascade stage %d needs a bound network with a single input"), StageIdx);
+            ReleaseHelpers(Helpers, InstanceFreed);
+            return false;
+        }
+
+        Helpers[StageIdx] = Network->AcquireIdleModelHelper();
+
+        if (!Helpers[StageIdx].IsValid())
         {
-            UE_LOG(LogTemp, Error, TEXT("Model is already running"));
+            ReleaseHelpers(Helpers, InstanceFreed);
+            return false;
         }
+
+        InstanceFreed[StageIdx] = Network->m_InstanceFreed;
+        Networks.AddUnique(Network);
     }
-    else
+
+    const double RequestTime = FPlatformTime::Seconds();
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> InferenceLatency = m_InferenceLatency;
+
+    LaunchWorkerJob([Input, Stages, Helpers = MoveTemp(Helpers), InstanceFreed = MoveTemp(InstanceFreed), Networks = MoveTemp(Networks), Result = MoveTemp(Result), ReleaseHelpers, RequestTime, InferenceLatency]()
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_Cascade);
+
+            // Tensor 0 is the cascade input, tensor N + 1 the output of stage N
+            TArray<FCascadeTensor> Tensors;
+            Tensors.SetNum(Stages.Num() + 1);
+            Tensors[0].Data = Input.Data;
+            Tensors[0].Shape = Input.Shape;
+
+            // One buffer per glue op, never resized after this so the views into them stay valid
+            TArray<TArray<float>> OpBuffers;
+            OpBuffers.SetNum(Stages.Num());
+
+            bool bSucceeded = true;
+            for (int32 StageIdx = 0; StageIdx < Stages.Num() && bSucceeded; ++StageIdx)
+            {
+                const FNNECascadeStage& Stage = Stages[StageIdx];
+                const FCascadeTensor& Source = Tensors[Stage.Source < 0 ? StageIdx : Stage.Source];
+                FCascadeTensor& Output = Tensors[StageIdx + 1];
+                TArray<float>& Buffer = OpBuffers[StageIdx];
+
+                switch (Stage.Op)
+                {
+                case ENNECascadeOp::Model:
+                    bSucceeded = RunCascadeModel(*Helpers[StageIdx], Source, Output);
+                    break;
+                case ENNECascadeOp::Crop:
+                {
+                    int32 X = Stage.X;
+                    int32 Y = Stage.Y;
+                    int32 Width = Stage.Width;
+                    int32 Height = Stage.Height;
+                    if (Stage.bBoxFromPrevious)
+                    {
+                        const TConstArrayView<float> Box = Tensors[StageIdx].Data;
+                        if (Box.Num() < 4 || Source.Shape.Num() < 2)
+                        {
+                            bSucceeded = false;
+                            break;
+                        }
+                        const int32 SourceHeight = Source.Shape[Source.Shape.Num() - 2];
+                        const int32 SourceWidth = Source.Shape[Source.Shape.Num() - 1];
+                        X = FMath::FloorToInt32(Box[0] * SourceWidth);
+                        Y = FMath::FloorToInt32(Box[1] * SourceHeight);
+                        Width = FMath::CeilToInt32(Box[2] * SourceWidth) - X;
+                        Height = FMath::CeilToInt32(Box[3] * SourceHeight) - Y;
+                    }
+                    bSucceeded = FNeuralNetworkCascadeOps::Crop(Source.Data, Source.Shape, X, Y, Width, Height, Buffer, Output.Shape);
+                    break;
+                }
+                case ENNECascadeOp::Resize:
+                    bSucceeded = FNeuralNetworkCascadeOps::Resize(Source.Data, Source.Shape, Stage.Width, Stage.Height, Buffer, Output.Shape);
+                    break;
+                case ENNECascadeOp::Normalize:
+                    bSucceeded = FNeuralNetworkCascadeOps::Normalize(Source.Data, Source.Shape, Stage.InputScale, Stage.Mean, Stage.Std, Buffer);
+                    Output.Shape = Source.Shape;
+                    break;
+                case ENNECascadeOp::ArgMax:
+                    Buffer.Add(FNeuralNetworkCascadeOps::ArgMax(Source.Data));
+                    Output.Shape = { 1 };
+                    bSucceeded = Source.Data.Num() > 0;
+                    break;
+                }
+
+                if (!bSucceeded)
+                {
+                    UE_LOG(LogNeuralNetwork, Error, TEXT("Cascade stage %d failed"), StageIdx);
+                }
+                else if (Stage.Op != ENNECascadeOp::Model)
+                {
+                    Output.Data = Buffer;
+                }
+            }
+
+            // The single copy of the cascade, the final tensor may live in a claimed instance's arena
+            TArray<float> FinalOutput;
+            if (bSucceeded)
+            {
+                FinalOutput = TArray<float>(Tensors.Last().Data.GetData(), Tensors.Last().Data.Num());
+            }
+
+            ReleaseHelpers(Helpers, InstanceFreed);
+
+            AsyncTask(ENamedThreads::GameThread, [Networks, Result, FinalOutput = MoveTemp(FinalOutput), RequestTime, InferenceLatency]()
+                {
+                    InferenceLatency->AddSample(FPlatformTime::Seconds() - RequestTime);
+                    INC_DWORD_STAT(STAT_NeuralNetwork_InferencesCompleted);
+
+                    {
+                        NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Callback);
+                        Result.ExecuteIfBound(FinalOutput);
+                    }
+
+                    for (const TWeakObjectPtr<ANeuralNetwork>& Network : Networks)
+                    {
+                        if (ANeuralNetwork* This = Network.Get())
+                        {
+                            This->DrainPendingRequests();
+                        }
+                    }
+                });
+        });
+
+    return true;
+}
+
+
+// Returns how many requests can be packed into one run. Models with a fixed batch dimension or several tensors run one request at a time.
+int32 ANeuralNetwork::GetSupportedBatchSize() const
+{
+    if (InputTensorDescs.Num() != 1 || OutputTensorDescs.Num() != 1 || InputTensorShapes.Num() == 0)
+    {
+        return 1;
+    }
+
+    TConstArrayView<int32> SymbolicDims = InputTensorDescs[0].GetShape().GetData();
+    const bool bVariableBatch = SymbolicDims.Num() > 0 && SymbolicDims[0] < 0;
+
+    return bVariableBatch ? FMath::Max(1, MaxBatchSize) : 1;
+}
+
+
+// Checked when queueing and again at flush time, bindings or shapes may have changed in between.
+bool ANeuralNetwork::CanRunBatchedInference() const
+{
+    if (!m_ModelHelper.IsValid() || InputTensorShapes.Num() == 0 || OutputTensorShapes.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Model helper is not valid or tensor shapes are not set, cannot run batched inference"));
+        return false;
+    }
+
+    if (InputTensorShapes.Num() != 1 || OutputTensorShapes.Num() != 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Batched inference supports only models with a single input and output tensor, use RunAsyncMultiInference"));
+        return false;
+    }
+
+    if (!m_ModelHelper->InputDataTypes.IsValidIndex(0) || !m_ModelHelper->OutputDataTypes.IsValidIndex(0) || m_ModelHelper->InputDataTypes[0] != ENNETensorDataType::Float || m_ModelHelper->OutputDataTypes[0] != ENNETensorDataType::Float)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Batched inference supports only float tensors, use RunAsyncInference"));
+        return false;
+    }
+
+    return true;
+}
+
+
+int32 ANeuralNetwork::GetNumPendingBatchedRequests() const
+{
+    return m_PendingBatch.Num();
+}
+
+
+// Takes the requests out of the queue before calling back, a callback may already enqueue the next request.
+void ANeuralNetwork::FailPendingBatch()
+{
+    TArray<FBatchedInferenceRequest> Failed = MoveTemp(m_PendingBatch);
+    m_PendingBatch.Reset();
+
+    const TArray<float> EmptyOutput;
+    for (const FBatchedInferenceRequest& Request : Failed)
+    {
+        Request.Result.ExecuteIfBound(EmptyOutput);
+    }
+}
+
+
+// Queues an inference request, the queue is run as one batch once it is full or its oldest request has waited MaxBatchWaitTime.
+bool ANeuralNetwork::EnqueueBatchedInference(const TArray<float>& InputData, FNNEAsyncInferenceDelegate Result)
+{
+    if (!CanRunBatchedInference())
+    {
+        return false;
+    }
+
+    FBatchedInferenceRequest& Request = m_PendingBatch.AddDefaulted_GetRef();
+    Request.InputData = InputData;
+    Request.Result = MoveTemp(Result);
+    Request.EnqueueTime = FPlatformTime::Seconds();
+
+    if (m_PendingBatch.Num() >= GetSupportedBatchSize())
+    {
+        FlushBatchedInference();
+    }
+
+    return true;
+}
+
+
+// Packs queued requests into batches and runs each batch on a free pooled instance with a single RunSync.
+void ANeuralNetwork::FlushBatchedInference()
+{
+    if (m_PendingBatch.Num() == 0)
+    {
+        return;
+    }
+
+    // Queued requests could never run, failing them keeps Tick from retrying and logging every frame
+    if (!CanRunBatchedInference())
+    {
+        FailPendingBatch();
+        return;
+    }
+
+    // Per request volumes, the caller's own shape may already carry a batch dimension greater than one
+    const UE::NNE::FTensorShape ItemInputShape = InputTensorShapes[0];
+    const uint32 ItemBatch = FMath::Max<uint32>(1, ItemInputShape.GetData()[0]);
+    const int32 InputItemVolume = ItemInputShape.Volume();
+    const int32 OutputItemVolume = OutputTensorShapes[0].Volume();
+    const int32 SupportedBatchSize = GetSupportedBatchSize();
+
+    // Requests with the wrong input length would corrupt the packed tensor, they fail with an empty output
+    TArray<FBatchedInferenceRequest> Mismatched;
+    for (int32 RequestIdx = m_PendingBatch.Num() - 1; RequestIdx >= 0; --RequestIdx)
+    {
+        if (m_PendingBatch[RequestIdx].InputData.Num() != InputItemVolume)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Dropping batched request, input length %d does not match %d"), m_PendingBatch[RequestIdx].InputData.Num(), InputItemVolume);
+            Mismatched.Emplace(MoveTemp(m_PendingBatch[RequestIdx]));
+            m_PendingBatch.RemoveAt(RequestIdx);
+        }
+    }
+    for (const FBatchedInferenceRequest& Request : Mismatched)
     {
-        UE_LOG(LogTemp, Error, TEXT("Model helper is not valid"));
+        Request.Result.ExecuteIfBound(TArray<float>());
     }
 
-    double InferenceStopped = FPlatformTime::Seconds();
-    double TimeElapsed = InferenceStopped - InferenceStarted;
-    UE_LOG(LogTemp, Warning, TEXT("Inference Time Elapsed: %f"), TimeElapsed);
+    while (m_PendingBatch.Num() > 0)
+    {
+        TSharedPtr<FModelHelper> ModelHelperPtr = AcquireIdleModelHelper();
+
+        if (!ModelHelperPtr.IsValid())
+        {
+            // Remaining requests are retried on the next tick
+            break;
+        }
+
+        const int32 BatchSize = FMath::Min(m_PendingBatch.Num(), SupportedBatchSize);
+        TArray<FBatchedInferenceRequest> Batch;
+        Batch.Reserve(BatchSize);
+        for (int32 ItemIdx = 0; ItemIdx < BatchSize; ++ItemIdx)
+        {
+            Batch.Emplace(MoveTemp(m_PendingBatch[ItemIdx]));
+        }
+        m_PendingBatch.RemoveAt(0, BatchSize, false);
+
+        // Batched shape is the caller's shape with the batch dimension scaled by the number of requests
+        TArray<uint32> BatchShapeData;
+        BatchShapeData.Append(ItemInputShape.GetData().GetData(), ItemInputShape.Rank());
+        BatchShapeData[0] = ItemBatch * BatchSize;
+        TArray<UE::NNE::FTensorShape> BatchInputShapes = { UE::NNE::FTensorShape::Make(BatchShapeData) };
+        TArray<UE::NNE::FTensorShape> ItemInputShapes = { ItemInputShape };
+
+        TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> InferenceLatency = m_InferenceLatency;
+        TSharedPtr<FEventRef, ESPMode::ThreadSafe> InstanceFreed = m_InstanceFreed;
+        TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> RunSyncLatency = m_RunSyncLatency;
+
+        LaunchWorkerJob([ModelHelperPtr, Batch = MoveTemp(Batch), BatchInputShapes = MoveTemp(BatchInputShapes), ItemInputShapes = MoveTemp(ItemInputShapes), InputItemVolume, OutputItemVolume, InferenceLatency, RunSyncLatency, InstanceFreed]() mutable
+            {
+                const int32 BatchSize = Batch.Num();
+                const double RunStarted = FPlatformTime::Seconds();
+                SET_FLOAT_STAT(STAT_NeuralNetwork_QueueWait, (RunStarted - Batch[0].EnqueueTime) * 1000.0);
+
+                // Pack every request into the contiguous batch tensor
+                ModelHelperPtr->BatchInputData.SetNumUninitialized(InputItemVolume * BatchSize, false);
+                ModelHelperPtr->BatchOutputData.SetNumUninitialized(OutputItemVolume * BatchSize, false);
+                for (int32 ItemIdx = 0; ItemIdx < BatchSize; ++ItemIdx)
+                {
+                    FMemory::Memcpy(ModelHelperPtr->BatchInputData.GetData() + ItemIdx * InputItemVolume, Batch[ItemIdx].InputData.GetData(), InputItemVolume * sizeof(float));
+                }
+
+                UE::NNE::FTensorBindingCPU InputBinding;
+                InputBinding.Data = ModelHelperPtr->BatchInputData.GetData();
+                InputBinding.SizeInBytes = ModelHelperPtr->BatchInputData.Num() * sizeof(float);
+
+                UE::NNE::FTensorBindingCPU OutputBinding;
+                OutputBinding.Data = ModelHelperPtr->BatchOutputData.GetData();
+                OutputBinding.SizeInBytes = ModelHelperPtr->BatchOutputData.Num() * sizeof(float);
+
+                bool bSuccess = true;
+                if (BatchSize > 1)
+                {
+                    bSuccess = ModelHelperPtr->ModelInstance->SetInputTensorShapes(BatchInputShapes) == 0;
+                }
+
+                if (bSuccess)
+                {
+                    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_RunSync);
+                    bSuccess = ModelHelperPtr->ModelInstance->RunSync(MakeArrayView(&InputBinding, 1), MakeArrayView(&OutputBinding, 1)) == 0;
+                }
+                RunSyncLatency->AddSample(FPlatformTime::Seconds() - RunStarted);
+
+                if (!bSuccess)
+                {
+                    UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to run the model on a batch of %d"), BatchSize);
+                }
+
+                // Restore the single request shape used by RunAsyncInference
+                if (BatchSize > 1)
+                {
+                    ModelHelperPtr->ModelInstance->SetInputTensorShapes(ItemInputShapes);
+                }
+
+                // Split the batch output back into one array per request, a failed run leaves every output empty like FailPendingBatch
+                TArray<TArray<float>> ItemOutputs;
+                ItemOutputs.SetNum(BatchSize);
+                if (bSuccess)
+                {
+                    for (int32 ItemIdx = 0; ItemIdx < BatchSize; ++ItemIdx)
+                    {
+                        ItemOutputs[ItemIdx].Append(ModelHelperPtr->BatchOutputData.GetData() + ItemIdx * OutputItemVolume, OutputItemVolume);
+                    }
+                }
+
+                ReleaseModelHelper(*ModelHelperPtr, *InstanceFreed);
+
+                AsyncTask(ENamedThreads::GameThread, [Batch = MoveTemp(Batch), ItemOutputs = MoveTemp(ItemOutputs), InferenceLatency]()
+                    {
+                        const double Now = FPlatformTime::Seconds();
+                        for (const FBatchedInferenceRequest& Request : Batch)
+                        {
+                            InferenceLatency->AddSample(Now - Request.EnqueueTime);
+                        }
+                        INC_DWORD_STAT_BY(STAT_NeuralNetwork_InferencesCompleted, Batch.Num());
+
+                        NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Callback);
+                        for (int32 ItemIdx = 0; ItemIdx < Batch.Num(); ++ItemIdx)
+                        {
+                            Batch[ItemIdx].Result.ExecuteIfBound(ItemOutputs[ItemIdx]);
+                        }
+                    });
+            });
+    }
 }
 
 
@@ -499,7 +3156,32 @@ void ANeuralNetwork::BeginPlay()
     Super::BeginPlay();
 }
 
+
+void ANeuralNetwork::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    StopContinuousInference();
+    m_bEndedPlay = true;
+    DropQueuedRequests();
+
+    // Waits for the running jobs, their results are dropped once the actor is gone
+    m_Executor.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ANeuralNetwork::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
+
+    // Instances freed since the last completion pick up queued requests here at the latest
+    DrainIncomingRequests();
+    DrainPendingRequests();
+
+    TickContinuousInference();
+
+    // Run a partial batch once its oldest request has waited long enough
+    if (m_PendingBatch.Num() > 0 && FPlatformTime::Seconds() - m_PendingBatch[0].EnqueueTime >= MaxBatchWaitTime)
+    {
+        FlushBatchedInference();
+    }
 }
@@ -10,21 +10,309 @@
 #include "NNERuntimeCPU.h"
 #include "NNEModelData.h"
 #include "Async/Async.h"
+#include "HAL/Event.h"
+#include "NeuralNetworkPreProcessing.h"
+#include "NeuralNetworkPostProcessing.h"
+#include "NeuralNetworkCaptureSource.h"
+#include "NeuralNetworkStats.h"
+#include "NeuralNetworkModelRegistry.h"
+#include "NeuralNetworkClipBuffer.h"
+#include "NeuralNetworkTensorTypes.h"
+#include "NeuralNetworkExecutor.h"
+#include "NeuralNetworkCascade.h"
+#include "Containers/Queue.h"
+#include <atomic>
 
 #include "NeuralNetwork.generated.h"
 
+// Flat tensor values and their shape, used by the multi-tensor inference path
+USTRUCT(BlueprintType)
+struct FNNETensorData
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    TArray<float> Data;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    TArray<int32> Shape;
+};
+
+// Per tile best class and score of a tiled inference, tiles in row-major order
+USTRUCT(BlueprintType)
+struct FNNETiledResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    int32 TilesX = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    int32 TilesY = 0;
+
+    // Tile size in source pixels
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    FIntPoint TileSize = FIntPoint::ZeroValue;
+
+    // Top left corner of every tile in source pixels
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    TArray<FIntPoint> TileOrigins;
+
+    // Best score of every tile, after PostProcessing
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    TArray<float> ScoreMap;
+
+    // Best class of every tile, -1 where nothing passed the threshold
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Inference")
+    TArray<int32> ClassMap;
+};
+
+// Where a request is in the pipeline, Completed, Cancelled and Dropped are final
+UENUM(BlueprintType)
+enum class ENNERequestStatus : uint8
+{
+    // Empty handle
+    None,
+    Queued,
+    Running,
+    Completed,
+    Cancelled,
+    // Rejected by the admission policy, invalid inputs or the actor ending play, or the model failed to run
+    Dropped
+};
+
+// Completion token of one request, shared by the caller and the pipeline. Every method is safe to call from any thread.
+class AI_PLAYGROUND_API FNeuralNetworkRequest
+{
+public:
+    // Outputs are only copied onto the request when bInKeepOutputs is set
+    explicit FNeuralNetworkRequest(bool bInKeepOutputs);
+
+    int64 GetId() const { return Id; }
+
+    ENNERequestStatus GetStatus() const { return static_cast<ENNERequestStatus>(Status.load(std::memory_order_acquire)); }
+
+    bool IsDone() const;
+
+    // Blocks until the request reaches a final status or the timeout passes, returns IsDone. Never call it on the game thread,
+    // which is where requests are admitted and dispatched.
+    bool Wait(uint32 TimeoutMs = MAX_uint32) const;
+
+    // Succeeds only while the request has not started running
+    bool Cancel();
+
+    // Every output of a completed request that keeps its outputs, read it only once GetStatus returned Completed
+    const TArray<FNNETensorData>& GetOutputs() const { return Outputs; }
+
+    bool KeepsOutputs() const { return bKeepOutputs; }
+
+    // Pipeline side. TryStart moves a queued request to Running and fails once it was cancelled.
+    bool TryStart();
+    void Complete(TArray<FNNETensorData> InOutputs);
+    void Drop();
+
+private:
+    // Publishes a final status if the request is still in From, waking every waiter
+    bool Finish(ENNERequestStatus From, ENNERequestStatus To);
+
+    static std::atomic<int64> NextId;
+
+    const int64 Id;
+    const bool bKeepOutputs;
+    std::atomic<uint8> Status;
+    TArray<FNNETensorData> Outputs;
+    FEventRef DoneEvent{ EEventMode::ManualReset };
+};
+
+using FNeuralNetworkRequestRef = TSharedRef<FNeuralNetworkRequest, ESPMode::ThreadSafe>;
+
+// Blueprint handle of a request returned by the RunAsync functions
+USTRUCT(BlueprintType)
+struct FNNERequestHandle
+{
+    GENERATED_BODY()
+
+    TSharedPtr<FNeuralNetworkRequest, ESPMode::ThreadSafe> Request;
+};
+
+// What RunAsyncInference, RunAsyncClassification and RunAsyncMultiInference do with a request while every instance is busy
+UENUM(BlueprintType)
+enum class ENNEAdmissionPolicy : uint8
+{
+    // Reject the request
+    DropIfBusy,
+    // Keep only the newest request pending, for real-time users that want the freshest frame
+    LatestWins,
+    // Queue up to MaxQueuedRequests requests and drop the oldest when full
+    BoundedQueue,
+    // Wait on the calling thread until an instance is free, for batch users that cannot drop anything
+    BlockUntilFree
+};
+
+// Priority of the dedicated inference threads
+UENUM(BlueprintType)
+enum class ENNEThreadPriority : uint8
+{
+    Lowest,
+    BelowNormal,
+    Normal,
+    AboveNormal
+};
+
 DECLARE_DYNAMIC_DELEGATE_OneParam(FNNEAsyncInferenceDelegate, const TArray<float>&, OutData);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FNNEAsyncMultiInferenceDelegate, const TArray<FNNETensorData>&, Outputs);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FNNEAsyncClassificationDelegate, const FNNEClassificationResult&, Result);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FNNEAsyncTiledInferenceDelegate, const FNNETiledResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNNEContinuousOutputDelegate, const TArray<float>&, OutData);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNNEContinuousClassificationDelegate, const FNNEClassificationResult&, Result);
+
+// Where a finished inference is delivered, outputs are only copied for the delegates that are bound
+struct FInferenceCompletion
+{
+    FNNEAsyncInferenceDelegate Result;
+    FNNEAsyncMultiInferenceDelegate MultiResult;
+
+    // Receives the first output reduced with PostProcess on the worker thread
+    FNNEAsyncClassificationDelegate ClassificationResult;
+    FNNEPostProcessSettings PostProcess;
+
+    // Set for requests whose outputs refresh the result cache and the temporal skip reference
+    bool bStoreForReuse = false;
+    bool bTemporalReference = false;
+    uint64 CacheKey = 0;
+    uint32 TemporalSeq = 0;
+    uint32 ReuseEpoch = 0;
+
+    // Token of the request, finished on the worker as soon as the outputs are copied out
+    TSharedPtr<FNeuralNetworkRequest, ESPMode::ThreadSafe> Request;
+};
+
+// Outputs kept for reuse, shared with the deliveries that read them
+using FReusableOutputs = TSharedPtr<const TArray<FNNETensorData>, ESPMode::ThreadSafe>;
+
+struct FCachedResult
+{
+    uint64 Key = 0;
+    FReusableOutputs Outputs;
+};
 
 // Helper class to store model-related data and operations
 class FModelHelper
 {
 public:
+    // Every tensor starts on its own cache line inside TensorArena
+    static constexpr uint64 TensorAlignment = 64;
+
     TUniquePtr<UE::NNE::IModelInstanceCPU> ModelInstance;
-    TArray<float> InputData;
-    TArray<float> OutputData;
+
+    // Model the instance was created from, kept alive for as long as the instance is
+    FSharedModelCPU Model;
+
+    // One allocation holding every input and output tensor, the bindings point into it
+    TArray<uint8, TAlignedHeapAllocator<TensorAlignment>> TensorArena;
     TArray<UE::NNE::FTensorBindingCPU> InputBindings;
     TArray<UE::NNE::FTensorBindingCPU> OutputBindings;
-    bool bIsRunning;
+    TArray<UE::NNE::FTensorShape> OutputShapes;
+
+    // Element type of every binding as declared by the model, the arena stores each tensor in its own type
+    TArray<ENNETensorDataType> InputDataTypes;
+    TArray<ENNETensorDataType> OutputDataTypes;
+
+    // Float copies of outputs stored in another type, filled on the worker by ReadOutput
+    TArray<TArray<float>> OutputConversion;
+
+    // Claimed with TryAcquire on the game thread, cleared by the worker as soon as the outputs are copied out
+    std::atomic<bool> bIsRunning{ false };
+
+    bool TryAcquire();
+
+    // Lays out every tensor in TensorArena, the arena is only reallocated when the tensor sizes change
+    void AllocateTensorArena(TConstArrayView<UE::NNE::FTensorShape> InInputShapes, TConstArrayView<UE::NNE::FTensorShape> InOutputShapes);
+
+    // Direct float views, empty for bindings stored in another type
+    TArrayView<float> GetInputData(int32 InputIdx) const;
+    TArrayView<float> GetOutputData(int32 OutputIdx) const;
+
+    // Number of elements of an input whatever its type
+    int32 GetInputNum(int32 InputIdx) const;
+
+    // Converts float values into the input's own type, a plain copy for float inputs
+    bool WriteInput(int32 InputIdx, TConstArrayView<float> Values);
+
+    // Float view of an output, converted into OutputConversion unless the output already is float
+    TConstArrayView<float> ReadOutput(int32 OutputIdx);
+
+    // Batch capacity buffers, grown on demand by batched inference
+    TArray<float> BatchInputData;
+    TArray<float> BatchOutputData;
+};
+
+// Persistent input buffer that callers fill in place before submitting it for inference
+struct FInputStagingBuffer
+{
+    // Num elements of DataType, the input's own type so preprocessing writes exactly what the binding reads
+    TArray<uint8, TAlignedHeapAllocator<FModelHelper::TensorAlignment>> Data;
+    ENNETensorDataType DataType = ENNETensorDataType::Float;
+    int32 Num = 0;
+    bool bInUse = false;
+
+    void Allocate(ENNETensorDataType InDataType, int32 InNum)
+    {
+        DataType = InDataType;
+        Num = InNum;
+        Data.SetNumZeroed(InNum * FNeuralNetworkTensorTypes::GetElementSize(InDataType));
+    }
+
+    template <typename ElementType>
+    TArrayView<ElementType> GetView()
+    {
+        return TArrayView<ElementType>(reinterpret_cast<ElementType*>(Data.GetData()), Num);
+    }
+};
+
+// First input read from memory outside the instance's arena, Release runs on the game thread once the run is done
+struct FExternalInputBinding
+{
+    void* Data = nullptr;
+    uint64 SizeInBytes = 0;
+    TFunction<void()> Release;
+};
+
+// Model instances, buffers and bindings fully prepared for one concrete input shape
+struct FPreparedShapeConfig
+{
+    TArray<uint32> ShapeKey;
+    TArray<UE::NNE::FTensorShape> InputShapes;
+    TArray<UE::NNE::FTensorShape> OutputShapes;
+    TArray<TSharedPtr<FModelHelper>> Pool;
+    TArray<TSharedPtr<FInputStagingBuffer>> Staging;
+    uint64 LastUsed = 0;
+};
+
+// Caller owned input values, one view per model input, only copied if the request has to wait
+using FInferenceInputViews = TArray<TConstArrayView<float>, TInlineAllocator<4>>;
+
+// Inference request waiting for a free instance under the LatestWins and BoundedQueue policies
+struct FPendingInferenceRequest
+{
+    // One array per model input
+    TArray<TArray<float>> Inputs;
+    FInferenceCompletion Completion;
+};
+
+// Request submitted from any thread through EnqueueInference, waiting for the game thread to admit it
+struct FIncomingInferenceRequest
+{
+    TArray<TArray<float>> Inputs;
+    TSharedPtr<FNeuralNetworkRequest, ESPMode::ThreadSafe> Request;
+};
+
+// Inference request waiting in the batching queue
+struct FBatchedInferenceRequest
+{
+    TArray<float> InputData;
+    FNNEAsyncInferenceDelegate Result;
+    double EnqueueTime = 0.0;
 };
 
 UCLASS()
@@ -36,6 +324,9 @@ public:
     // Sets default values for this actor's properties
     ANeuralNetwork();
 
+    // Called every frame
+    virtual void Tick(float DeltaTime) override;
+
     // Model Creation
     UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
     void LoadModelDataAsync();
@@ -43,6 +334,42 @@ public:
     UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
     bool CreateCPUModel();
 
+    // Builds the model and its instances on a background thread and warms them up, OnModelReady fires on the game thread when done
+    UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
+    void CreateCPUModelAsync();
+
+    // True once CreateCPUModel or CreateCPUModelAsync has installed a model
+    UFUNCTION(BlueprintPure, Category = "NNE Neural Network")
+    bool IsModelReady() const;
+
+    // True between CreateCPUModelAsync and its OnModelReady
+    bool IsModelCreationPending() const;
+
+    // Upper bound of dummy inferences per instance in CreateCPUModelAsync, warm-up stops early once two runs in a row agree within WarmUpTolerance
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Neural Network", meta = (ClampMin = "0", UIMin = "0"))
+    int32 NumWarmUpRuns = 5;
+
+    // Relative difference between consecutive warm-up runs that counts as steady state
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Neural Network", meta = (ClampMin = "0.0"))
+    float WarmUpTolerance = 0.1f;
+
+    // Model Pool
+    UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
+    int32 GetNumIdleModelInstances();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
+    int32 GetNumModelInstances() const;
+
+    // Instrumentation
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetInferenceLatencyStats(float& P50Ms, float& P95Ms, float& P99Ms, float& InferencesPerSecond);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetRunSyncLatencyStats(float& P50Ms, float& P95Ms, float& P99Ms, float& RunsPerSecond);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void ResetLatencyStats();
+
     // Model Info
     // Getters
     UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
@@ -58,6 +385,8 @@ public:
     void GetOutputTensorShape(int32 OutputIdx, bool isModelRunning, int32& Rank, int32& Volume, int32& Dimension, int32& PredOpts);
 
     // Setters
+    // Instances running a request are swapped for freshly configured ones instead of being stopped, the request finishes
+    // on its old configuration and later requests use the new one. isModelRunning is only kept for existing Blueprints.
     UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
     void SetInputTensorShapes(bool isModelRunning, int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width);
 
@@ -67,17 +396,52 @@ public:
     UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
     void CreateOutputTensorBinding(bool isModelRunning, bool& OutBSuccess);
 
+    // Sets shapes, resolves outputs and binds buffers for a concrete input shape in one call, switching back to a recently used shape is a cache lookup
+    UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
+    void ActivateInputShape(int32 Rank, int32 Dimension, int32 Frame, int32 ColorChannels, int32 Height, int32 Width, bool& bSuccess);
+
+    // Number of prepared input shape configurations kept by ActivateInputShape, each holds its own model instances and buffers
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Neural Network", meta = (ClampMin = "1", UIMin = "1"))
+    int32 MaxCachedShapeConfigs = 4;
+
     // Image Capture Method
     UFUNCTION(BlueprintCallable, Category = "NNE Data ImageCapture")
     void RT2PixelBuffer(UTextureRenderTarget2D* InputRT, TArray<FColor>& ImagePixelBuffer, int32& OriginalHeight, int32& OriginalWidth);
 
+    // Pipelined capture, readbacks are requested now and picked up a few frames later without stalling the game thread
+    UFUNCTION(BlueprintCallable, Category = "NNE Data ImageCapture")
+    void SetCaptureRenderTarget(UTextureRenderTarget2D* InputRT);
+
+    // Drives the pipeline from a CPU generated test pattern instead of a render target, works with -nullrhi
+    UFUNCTION(BlueprintCallable, Category = "NNE Data ImageCapture")
+    void SetSyntheticCaptureSource(int32 Width, int32 Height);
+
+    void SetCaptureSource(TSharedPtr<INeuralNetworkCaptureSource> InCaptureSource);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Data ImageCapture")
+    bool RequestCapture();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Data ImageCapture")
+    bool TryGetCapture(TArray<FColor>& ImagePixelBuffer, int32& OriginalHeight, int32& OriginalWidth);
+
+    // Number of GPU staging buffers, which is also how many captures can be in flight
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data ImageCapture", meta = (ClampMin = "1", UIMin = "1"))
+    int32 NumCaptureStagingBuffers = 3;
+
 
     // Data PreProcessing
     UFUNCTION(BlueprintCallable, Category = "NNE Data PreProcessing")
-    void ResizeImage(TArray<FColor> ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, TArray<FLinearColor>& ResizedPixelBuffer, int32& ResizedHeight, int32& ResizedWidth);
+    void ResizeImage(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, TArray<FLinearColor>& ResizedPixelBuffer, int32& ResizedHeight, int32& ResizedWidth);
 
     UFUNCTION(BlueprintCallable, Category = "NNE Data PreProcessing")
-    void NormalizeImage(TArray<FLinearColor> ImageBuffer, int32 ColorChannels, TArray<float>& FlatImg);
+    void NormalizeImage(const TArray<FLinearColor>& ImageBuffer, int32 ColorChannels, TArray<float>& FlatImg);
+
+    // Resize, color conversion and normalization fused into a single pass over the pixel buffer
+    UFUNCTION(BlueprintCallable, Category = "NNE Data PreProcessing")
+    void PreProcessImage(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32 ResizeHeight, int32 ResizeWidth, const FNNEImageNormalization& Normalization, TArray<float>& FlatImg);
+
+    // Preprocesses a pixel buffer straight into a free input staging buffer, ready for SubmitStagedInference
+    bool PreProcessImageToStaging(TConstArrayView<FColor> ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, int32& OutStagingIdx);
 
     // Properties
     UPROPERTY(EditAnywhere)
@@ -86,23 +450,249 @@ public:
     UPROPERTY(BlueprintReadOnly, Category = "NNE Neural Network")
     bool IsModelRunning = false;
 
+    // Filter used by ResizeImage, PreProcessImage and PreProcessImageToStaging
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    ENNEResizeFilter ResizeFilter = ENNEResizeFilter::Area;
+
+    // Mean, std, channel order and color decoding used by NormalizeImage and PreProcessImageToStaging
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    FNNEImageNormalization InputNormalization;
+
+    // Number of model instances created from the single model, each with its own bindings, so several inferences can be in flight at once
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Neural Network", meta = (ClampMin = "1", UIMin = "1"))
+    int32 NumModelInstances = 1;
+
+    // Create the model once per model asset and share it with every actor using it, only the instances are per actor
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Neural Network")
+    bool bUseSharedModelRegistry = true;
+
     // Events
     UFUNCTION(BlueprintImplementableEvent, Category = "NNE Inference")
     void OnModelDataLoaded();
 
-    // Async
+    // Fired by CreateCPUModelAsync after the instances are warmed up, SecondsToReady is measured from the call
+    UFUNCTION(BlueprintImplementableEvent, Category = "NNE Inference")
+    void OnModelReady(bool bSuccess, float SecondsToReady);
+
+    // Async, fills the first input tensor and returns the first output tensor
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    FNNERequestHandle RunAsyncInference(bool InBSuccess, bool OutBSuccess, const TArray<float>& InputData, FNNEAsyncInferenceDelegate Result);
+
+    // Async with the first output reduced on the worker thread as configured in PostProcessing
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    FNNERequestHandle RunAsyncClassification(const TArray<float>& InputData, FNNEAsyncClassificationDelegate Result);
+
+    // Request tokens, the handle of a finished request keeps its final status
+    UFUNCTION(BlueprintPure, Category = "NNE Inference")
+    static ENNERequestStatus GetRequestStatus(const FNNERequestHandle& Handle);
+
+    // Unique per process, 0 for an empty handle
+    UFUNCTION(BlueprintPure, Category = "NNE Inference")
+    static int64 GetRequestId(const FNNERequestHandle& Handle);
+
+    // Cancels a request that has not started running yet, its delegate is never called
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    static bool CancelRequest(const FNNERequestHandle& Handle);
+
+    // Submission for C++ producers on any thread, e.g. AI controllers or capture callbacks. The inputs go through a lock-free
+    // queue the game thread drains into the admission policy, the outputs are kept on the returned request.
+    FNeuralNetworkRequestRef EnqueueInference(TArray<TArray<float>> Inputs);
+
+    // Threads running inference and preprocessing jobs, 0 shares the engine task graph workers. Read when the first job is launched.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0", UIMin = "0"))
+    int32 InferenceThreads = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    ENNEThreadPriority InferenceThreadPriority = ENNEThreadPriority::BelowNormal;
+
+    // Cores the inference threads may run on, one bit per core, 0 allows every core
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    int64 InferenceAffinityMask = 0;
+
+    // Worker count, jobs waiting for a worker and the busy fraction of the workers since the previous call, all zero without InferenceThreads
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetExecutorStats(int32& NumWorkers, int32& QueueDepth, float& Utilization);
+
+    // Reductions applied by RunAsyncClassification
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PostProcessing")
+    FNNEPostProcessSettings PostProcessing;
+
+    // Async for models with several inputs and outputs, one entry per tensor in model order
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    FNNERequestHandle RunAsyncMultiInference(const TArray<FNNETensorData>& Inputs, FNNEAsyncMultiInferenceDelegate Result);
+
+    // Zero-copy input staging
+    // Returns a writable view of a free staging buffer sized for the input tensor, empty if every buffer is in use or the input is not float
+    TArrayView<float> BeginInputStaging(int32& OutStagingIdx);
+
+    // Runs inference directly on a staging buffer returned by BeginInputStaging, false if no model instance is free
+    bool SubmitStagedInference(int32 StagingIdx, FNNEAsyncInferenceDelegate Result);
+
+    // Releases a staging buffer without running inference on it
+    void CancelInputStaging(int32 StagingIdx);
+
+    // Number of persistent input buffers, two lets the next frame be filled while the previous one is inferred
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "1", UIMin = "1"))
+    int32 NumInputStagingBuffers = 2;
+
+    // Admission
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    ENNEAdmissionPolicy AdmissionPolicy = ENNEAdmissionPolicy::DropIfBusy;
+
+    // Capacity of the BoundedQueue policy
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "1", UIMin = "1"))
+    int32 MaxQueuedRequests = 8;
+
+    // Longest BlockUntilFree waits before dropping the request, in seconds
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0"))
+    float MaxBlockTime = 1.0f;
+
+    // Requests queued, replaced by a newer one under LatestWins, and dropped since the last reset, plus the ones pending now
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetAdmissionStats(int32& NumQueued, int32& NumReplaced, int32& NumDropped, int32& NumPending);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void ResetAdmissionStats();
+
+    // Result reuse for static or nearly static inputs, applies to RunAsyncInference, RunAsyncClassification,
+    // RunAsyncMultiInference and float staging buffers
+    // Serve inputs identical to a recent one from a small LRU, matched by a 64-bit hash of the input tensors
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    bool bCacheResults = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "1", UIMin = "1"))
+    int32 ResultCacheSize = 8;
+
+    // Reuse the last result while the input stays within TemporalSkipThreshold of the last inferred input
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    bool bTemporalSkip = false;
+
+    // Mean absolute difference per input value below which a frame counts as unchanged
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0"))
+    float TemporalSkipThreshold = 0.01f;
+
+    // Consecutive skipped frames before the model runs again anyway, 0 never forces a run
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0", UIMin = "0"))
+    int32 TemporalSkipMaxFrames = 30;
+
+    // Share of looked up requests served without running the model, and how many were, since the last clear
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetResultReuseStats(float& HitRate, int32& InferencesAvoided, int32& NumLookups);
+
+    // Forgets cached results, the temporal reference and the reuse stats, e.g. after changing the model's inputs
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    void ClearResultCache();
+
+    // Continuous mode, Tick runs capture, preprocessing and inference itself
+    // Starts the pipeline on the render target, or on the current capture source when InputRT is null. Needs the input bindings.
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool StartContinuousInference(UTextureRenderTarget2D* InputRT);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    void StopContinuousInference();
+
+    // Current slowdown applied to the intervals because of the budget, the smoothed game thread cost and the frames submitted
+    UFUNCTION(BlueprintCallable, Category = "NNE Stats")
+    void GetContinuousStats(float& IntervalScale, float& AverageGameThreadMs, int32& NumSubmitted);
+
+    // Start a capture every this many frames, 0 for every frame
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0", UIMin = "0"))
+    int32 ContinuousFrameInterval = 0;
+
+    // Start a capture at most every this many seconds, 0 for no limit. With both intervals set a capture waits for both.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0"))
+    float ContinuousTimeInterval = 0.0f;
+
+    // Game thread time the pipeline may take per frame, the intervals are stretched while it is exceeded and relaxed again below half of it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0"))
+    float ContinuousBudgetMs = 2.0f;
+
+    // Results of the continuous mode, the outputs are only copied for the events that have listeners
+    UPROPERTY(BlueprintAssignable, Category = "NNE Inference")
+    FNNEContinuousOutputDelegate OnContinuousOutput;
+
+    // Reduced with PostProcessing on the worker thread
+    UPROPERTY(BlueprintAssignable, Category = "NNE Inference")
+    FNNEContinuousClassificationDelegate OnContinuousClassification;
+
+    // Streaming clips for rank 5 [1, Frame, C, H, W] inputs
+    // Sizes the frame ring for the current input shape, call again after the input shape changes
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool BeginClipStreaming();
+
+    // Preprocesses one captured frame into the next ring slot, false while that slot is still being inferred
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool PushClipFrame(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth);
+
+    // Runs inference on the newest Frame frames in place, false until enough frames were pushed or if no instance is free
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool RunAsyncClipInference(FNNEAsyncInferenceDelegate Result);
+
+    // Ring slots beyond the clip length, each lets one more frame be pushed while an earlier clip is still being inferred
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0", UIMin = "0"))
+    int32 NumClipSpareFrames = 2;
+
+    // Tiled inference over images larger than the model input
+    // Splits the image into overlapping tiles and runs them across every idle instance, false if no instance is free or the input is not a rank 4 image
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool RunAsyncTiledInference(const TArray<FColor>& ImagePixelBuffer, int32 OriginalHeight, int32 OriginalWidth, FNNEAsyncTiledInferenceDelegate Result);
+
+    // Fraction of a tile shared with its neighbour, more overlap means more tiles
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0", ClampMax = "0.9", UIMin = "0.0", UIMax = "0.9"))
+    float TileOverlap = 0.25f;
+
+    // Source pixels per model input pixel, 1 runs tiles at native resolution, larger values cover more of the image per tile
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.1", UIMin = "0.1"))
+    float TileSourceScale = 1.0f;
+
+    // Cascades of several models and glue ops
+    // Runs every stage back to back on one worker job and delivers only the last stage's output, empty if a stage failed.
+    // Each model stage claims an idle instance of its network up front, false if one is busy or its network does not take a single input.
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool RunAsyncCascade(const FNNETensorData& Input, const TArray<FNNECascadeStage>& Stages, FNNEAsyncInferenceDelegate Result);
+
+    // Batching
+    // False if the model cannot be batched, requests that turn out not to be runnable at flush time get an empty output
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    bool EnqueueBatchedInference(const TArray<float>& InputData, FNNEAsyncInferenceDelegate Result);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    void FlushBatchedInference();
+
+    // True if the bound model takes batched requests, a single float input and output with known shapes. Logs why not otherwise.
     UFUNCTION(BlueprintCallable, Category = "NNE Inference")
-    void RunAsyncInference(bool InBSuccess, bool OutBSuccess, TArray<float> InputData, FNNEAsyncInferenceDelegate Result);
+    bool CanRunBatchedInference() const;
+
+    // Requests queued but not yet handed to an instance
+    UFUNCTION(BlueprintCallable, Category = "NNE Inference")
+    int32 GetNumPendingBatchedRequests() const;
+
+    // Largest number of queued requests packed into one run, only used when the model's batch dimension is variable
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "1", UIMin = "1"))
+    int32 MaxBatchSize = 8;
+
+    // Seconds the oldest queued request may wait before a partial batch is run
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "0.0"))
+    float MaxBatchWaitTime = 0.005f;
+
+protected:
+    // Called when the game starts or when spawned
+    virtual void BeginPlay() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 
-    // Controlled Access
+    // Held while the pool and tensor shapes are reconfigured, the request path claims instances without it
     FCriticalSection m_mutex;
 
-    // Model Base
+    // Model Base, m_ModelHelper is the first pooled instance and is used for tensor info queries
     TSharedPtr<FModelHelper> m_ModelHelper;
 
-    TUniquePtr<UE::NNE::IModelCPU> Model;
+    TArray<TSharedPtr<FModelHelper>> m_ModelHelperPool;
+
+    // Shared with every actor using the same model data when bUseSharedModelRegistry is set
+    FSharedModelCPU Model;
 
     // Model Input Info
     TConstArrayView<UE::NNE::FTensorDesc> InputTensorDescs;
@@ -119,4 +709,177 @@ private:
     TArray<UE::NNE::FTensorShape> OutputTensorShapes;
 
     TArray<float> tempModelInput;
+
+    // Creates NumInstances instances from InModel, safe to call off the game thread
+    static bool CreateModelHelperPool(const FSharedModelCPU& InModel, int32 NumInstances, TArray<TSharedPtr<FModelHelper>>& OutPool);
+
+    // Registry to share the model through, nullptr when bUseSharedModelRegistry is off
+    UNeuralNetworkModelRegistry* GetModelRegistry() const;
+
+    // Runs dummy inferences until the run time settles, skipped for inputs with variable dimensions
+    static void WarmUpModelHelper(FModelHelper& ModelHelper, int32 MaxRuns, float Tolerance);
+
+    // Makes a freshly created model and pool the active ones
+    void InstallModel(FSharedModelCPU NewModel, TArray<TSharedPtr<FModelHelper>> NewPool);
+
+    bool m_bModelCreationPending = false;
+    bool m_bModelReady = false;
+
+    // Builds instances, shapes, buffers and bindings for one concrete input shape
+    TSharedPtr<FPreparedShapeConfig> PrepareShapeConfig(const TArray<uint32>& ShapeData);
+
+    // Prepared configurations of ActivateInputShape, least recently used is evicted first, only accessed on the game thread
+    TArray<TSharedPtr<FPreparedShapeConfig>> m_ShapeCache;
+
+    uint64 m_ShapeCacheClock = 0;
+
+    // Replaces every running pooled instance with an idle one configured the same way, so the setters never touch an
+    // instance an inference is using. Also drops the prepared shape configuration owning the active pool.
+    // Returns false if a replacement could not be created. Must be called with m_mutex held.
+    bool SwapOutRunningModelHelpers();
+
+    // Returns a free pooled instance marked as running, or nullptr if all instances are busy
+    TSharedPtr<FModelHelper> AcquireIdleModelHelper();
+
+    // Every worker side job goes through here, onto the dedicated executor when InferenceThreads is set
+    void LaunchWorkerJob(TUniqueFunction<void()> Job);
+
+    // Created by the first LaunchWorkerJob, destroyed at EndPlay after its running jobs finished
+    TUniquePtr<FNeuralNetworkExecutor> m_Executor;
+
+    // Rolling latency windows, shared with in-flight tasks
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> m_InferenceLatency;
+    TSharedPtr<FNeuralNetworkLatencyTracker, ESPMode::ThreadSafe> m_RunSyncLatency;
+
+    // Active pipelined capture source, only accessed on the game thread
+    TSharedPtr<INeuralNetworkCaptureSource> m_CaptureSource;
+
+    // Persistent input buffers handed out by BeginInputStaging, only accessed on the game thread
+    TArray<TSharedPtr<FInputStagingBuffer>> m_InputStaging;
+
+    // Runs the instance on a worker thread and delivers its output on the game thread, releasing the instance and external input afterwards
+    void DispatchInference(TSharedPtr<FModelHelper> ModelHelperPtr, FInferenceCompletion Completion, FExternalInputBinding ExternalInput = FExternalInputBinding());
+
+    // Claims an instance for a filled staging buffer and dispatches it, Completion is only consumed on success
+    bool SubmitStaged(int32 StagingIdx, FInferenceCompletion& Completion);
+
+    // Reserves a free staging buffer of any element type, nullptr if every buffer is in use
+    FInputStagingBuffer* AcquireInputStaging(int32& OutStagingIdx);
+
+    // Reads the image layout from the rank 4 input shape and reserves a staging buffer for one preprocessed frame
+    FInputStagingBuffer* AcquireImageStaging(FNNEImageNormalization& OutNormalization, int32& OutHeight, int32& OutWidth, int32& OutStagingIdx);
+
+    // Preprocesses the current capture on the executor, the frame is staged on the game thread once the job is done
+    void PreProcessContinuousFrame(int32 CaptureHeight, int32 CaptureWidth);
+
+    // One step of the continuous pipeline, called from Tick
+    void TickContinuousInference();
+
+    UFUNCTION()
+    void HandleContinuousOutput(const TArray<float>& OutData);
+
+    UFUNCTION()
+    void HandleContinuousClassification(const FNNEClassificationResult& Result);
+
+    bool m_bContinuousActive = false;
+
+    // Preprocessed frame still waiting for a free instance
+    int32 m_ContinuousStagingIdx = INDEX_NONE;
+
+    // A capture is being preprocessed on the executor, no further capture is taken until it is staged
+    bool m_bContinuousPreProcessing = false;
+
+    int32 m_FramesSinceCapture = 0;
+    double m_LastCaptureTime = 0.0;
+    float m_ContinuousIntervalScale = 1.0f;
+    float m_ContinuousAverageMs = 0.0f;
+    int32 m_NumContinuousSubmitted = 0;
+
+    // Reused capture buffer, keeps its allocation between frames
+    TArray<FColor> m_ContinuousPixels;
+
+    // Frame ring of the streaming clip mode, only accessed on the game thread
+    TSharedPtr<FNeuralNetworkClipBuffer> m_ClipBuffer;
+
+    // Per frame view of the rank 5 input shape, filled by BeginClipStreaming
+    int32 m_ClipFrameHeight = 0;
+    int32 m_ClipFrameWidth = 0;
+    FNNEImageNormalization m_ClipNormalization;
+
+    // Runs the request on a free instance or applies AdmissionPolicy to it, game thread only
+    void SubmitInference(const FInferenceInputViews& Inputs, FInferenceCompletion Completion);
+
+    // Copies the inputs into a free instance and dispatches it, Completion is only consumed on success
+    bool TryDispatchInputs(const FInferenceInputViews& Inputs, FInferenceCompletion& Completion);
+
+    // Dispatches pending requests, oldest first, while instances are free
+    void DrainPendingRequests();
+
+    // Serves the request from the result cache or the temporal reference, otherwise marks it to refresh them
+    bool TryReuseResult(const FInferenceInputViews& Inputs, FInferenceCompletion& Completion, TFunction<void()> Release = nullptr);
+
+    // Runs the delegates of a request served by TryReuseResult on the game thread
+    static void DeliverReusedResult(FReusableOutputs Reused, FInferenceCompletion Completion, TFunction<void()> Release, FNNEClassificationResult Classification);
+
+    // Makes the input of a request being dispatched the temporal skip reference
+    void AdoptTemporalReference(TConstArrayView<float> Input, FInferenceCompletion& Completion);
+
+    // Keeps the outputs of a finished request marked by TryReuseResult
+    void StoreReusableResult(const FInferenceCompletion& Completion, const TArray<FNNETensorData>& Outputs);
+
+    // Least recently used first, only accessed on the game thread
+    TArray<FCachedResult> m_ResultCache;
+
+    // Last input sent to the model under temporal skip, and the outputs once they arrived for that same input
+    TArray<float> m_TemporalInput;
+    FReusableOutputs m_TemporalOutputs;
+    uint32 m_TemporalInputSeq = 0;
+    uint32 m_TemporalOutputSeq = 0;
+
+    // Bumped by ClearResultCache so outputs of requests submitted before it are not stored
+    uint32 m_ReuseEpoch = 0;
+    int32 m_ConsecutiveSkips = 0;
+
+    int32 m_NumReuseLookups = 0;
+    int32 m_NumReused = 0;
+
+    // True when the inputs match the active input bindings
+    bool InputsMatchBindings(const FInferenceInputViews& Inputs) const;
+
+    // Requests of the LatestWins and BoundedQueue policies, oldest first, only accessed on the game thread
+    TArray<FPendingInferenceRequest> m_PendingRequests;
+
+    int32 m_NumQueued = 0;
+    int32 m_NumReplaced = 0;
+    int32 m_NumDropped = 0;
+
+    // Filled by EnqueueInference on any thread, only dequeued on the game thread
+    TQueue<FIncomingInferenceRequest, EQueueMode::Mpsc> m_IncomingRequests;
+
+    // Set while a game thread task to drain m_IncomingRequests is on its way, so producers schedule at most one
+    std::atomic<bool> m_bIncomingDrainScheduled{ false };
+
+    // Set in EndPlay, requests enqueued afterwards are dropped right away
+    std::atomic<bool> m_bEndedPlay{ false };
+
+    // Hands every incoming request to SubmitInference, cancelled ones are skipped
+    void DrainIncomingRequests();
+
+    // Finishes every request that has not been dispatched yet as dropped, so nobody waits on them after EndPlay
+    void DropQueuedRequests();
+
+    // Attaches a fresh token to the completion and returns its handle
+    static FNNERequestHandle AttachRequest(FInferenceCompletion& Completion);
+
+    // Triggered by workers whenever they release an instance, BlockUntilFree waits on it
+    TSharedPtr<FEventRef, ESPMode::ThreadSafe> m_InstanceFreed;
+
+    // Requests waiting to be packed into a batch, only accessed on the game thread
+    TArray<FBatchedInferenceRequest> m_PendingBatch;
+
+    // Completes every queued batched request with an empty output
+    void FailPendingBatch();
+
+    // Returns how many requests can share one run given the model's batch dimension
+    int32 GetSupportedBatchSize() const;
 };
@@ -0,0 +1,433 @@
+#include "NeuralNetworkBatchInferenceCommandlet.h"
+#include "NeuralNetwork.h"
+#include "NeuralNetworkStats.h"
+#include "ImageUtils.h"
+#include "ImageCore.h"
+#include "IImageWrapperModule.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace
+{
+    constexpr uint32 PredictionsMagic = 0x50454E4E; // "NNEP"
+    constexpr uint32 PredictionsVersion = 1;
+
+    bool IsRawRecordFile(const FString& Path)
+    {
+        return FPaths::GetExtension(Path).Equals(TEXT("raw"), ESearchCase::IgnoreCase) || Path.EndsWith(TEXT("ubyte"), ESearchCase::IgnoreCase);
+    }
+
+    bool IsImageFile(const FString& Path)
+    {
+        const FString Extension = FPaths::GetExtension(Path);
+        return Extension.Equals(TEXT("png"), ESearchCase::IgnoreCase) || Extension.Equals(TEXT("jpg"), ESearchCase::IgnoreCase)
+            || Extension.Equals(TEXT("jpeg"), ESearchCase::IgnoreCase) || Extension.Equals(TEXT("bmp"), ESearchCase::IgnoreCase)
+            || Extension.Equals(TEXT("exr"), ESearchCase::IgnoreCase);
+    }
+
+    void WriteUTF8(FArchive& Ar, const FString& Text)
+    {
+        FTCHARToUTF8 Converted(*Text);
+        Ar.Serialize(const_cast<ANSICHAR*>(Converted.Get()), Converted.Length());
+    }
+}
+
+
+UNeuralNetworkBatchInferenceCommandlet::UNeuralNetworkBatchInferenceCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+
+int32 UNeuralNetworkBatchInferenceCommandlet::Main(const FString& Params)
+{
+    FString ModelPath;
+    FString InputDir;
+    FParse::Value(*Params, TEXT("Model="), ModelPath);
+    FParse::Value(*Params, TEXT("Input="), InputDir);
+
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("NeuralNetworkPredictions.csv");
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    int32 WindowSize = 256;
+    int32 BatchSize = 8;
+    int32 NumInstances = 2;
+    int32 TopK = 1;
+    FParse::Value(*Params, TEXT("Repeat="), NumPasses);
+    FParse::Value(*Params, TEXT("Window="), WindowSize);
+    FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+    FParse::Value(*Params, TEXT("Instances="), NumInstances);
+    FParse::Value(*Params, TEXT("TopK="), TopK);
+    FParse::Value(*Params, TEXT("RawWidth="), RawWidth);
+    FParse::Value(*Params, TEXT("RawHeight="), RawHeight);
+    FParse::Value(*Params, TEXT("RawChannels="), RawChannels);
+    FParse::Value(*Params, TEXT("RawHeader="), RawHeader);
+    NumPasses = FMath::Max(1, NumPasses);
+    WindowSize = FMath::Max(1, WindowSize);
+    TopK = FMath::Max(1, TopK);
+
+    if (RawWidth <= 0 || RawHeight <= 0 || (RawChannels != 1 && RawChannels != 3 && RawChannels != 4) || RawHeader < 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Raw records need a positive size and 1, 3 or 4 channels"));
+        return 1;
+    }
+
+    IFileManager::Get().FindFilesRecursive(Files, *InputDir, TEXT("*"), true, false);
+    Files.RemoveAll([](const FString& Path) { return !IsRawRecordFile(Path) && !IsImageFile(Path); });
+    Files.Sort();
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("No images or raw record files in %s"), *InputDir);
+        return 1;
+    }
+
+    UNNEModelData* ModelData = TSoftObjectPtr<UNNEModelData>(FSoftObjectPath(ModelPath)).LoadSynchronous();
+    if (!ModelData)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not load model %s"), *ModelPath);
+        return 1;
+    }
+
+    Network = NewObject<ANeuralNetwork>(GetTransientPackage());
+    Network->LazyLoadedModelData = ModelData;
+    Network->NumModelInstances = FMath::Max(1, NumInstances);
+    Network->MaxBatchSize = FMath::Max(1, BatchSize);
+    if (!Network->CreateCPUModel())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not create the model"));
+        return 1;
+    }
+
+    int32 NumInputs, InputIdx, Rank, Volume, Dimension, Frame, ColorChannels, PredOpts;
+    Network->GetInputTensorDescs(false, NumInputs, InputIdx);
+    Network->GetInputTensorShape(0, false, Rank, Volume, Dimension, Frame, ColorChannels, Height, Width);
+    Network->GetOutputTensorDescs(false);
+    Network->GetOutputTensorShape(0, false, Rank, Volume, Dimension, PredOpts);
+
+    bool bInSuccess = false;
+    bool bOutSuccess = false;
+    Network->CreateInputTensorBinding(false, bInSuccess);
+    Network->CreateOutputTensorBinding(false, bOutSuccess);
+    if (!bInSuccess || !bOutSuccess || Height <= 0 || Width <= 0 || (ColorChannels != 1 && ColorChannels != 3))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Batch inference needs a fixed size 1 or 3 channel image input"));
+        return 1;
+    }
+
+    // Input and output have to be single float tensors, otherwise every queued request would fail
+    if (!Network->CanRunBatchedInference())
+    {
+        return 1;
+    }
+
+    Normalization = Network->InputNormalization;
+    Normalization.ColorChannels = ColorChannels;
+    Normalization.Layout = FParse::Param(*Params, TEXT("NHWC")) ? ENNETensorLayout::NHWC : ENNETensorLayout::NCHW;
+
+    Reduction = Network->PostProcessing;
+    Reduction.TopK = TopK;
+    Reduction.bPerLocation = false;
+
+    // Loaded here, the decoders run on worker threads
+    FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    bBinaryOutput = !FPaths::GetExtension(OutputPath).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+    Output.Reset(IFileManager::Get().CreateFileWriter(*OutputPath));
+    if (!Output.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not open %s"), *OutputPath);
+        return 1;
+    }
+
+    if (bBinaryOutput)
+    {
+        uint32 Magic = PredictionsMagic;
+        uint32 Version = PredictionsVersion;
+        uint32 NumClasses = TopK;
+        *Output << Magic << Version << NumClasses;
+    }
+    else
+    {
+        FString CsvHeader = TEXT("image");
+        for (int32 ClassRank = 0; ClassRank < TopK; ++ClassRank)
+        {
+            CsvHeader += FString::Printf(TEXT(",class_%d,score_%d"), ClassRank, ClassRank);
+        }
+        WriteUTF8(*Output, CsvHeader + TEXT("\n"));
+    }
+
+    Sinks.SetNum(WindowSize);
+    for (int32 Slot = 0; Slot < WindowSize; ++Slot)
+    {
+        Sinks[Slot] = NewObject<UNeuralNetworkBatchInferenceSink>(this);
+        Sinks[Slot]->Slot = Slot;
+        Sinks[Slot]->OnResult = [this](int32 ResultSlot, const TArray<float>& OutData) { HandleResult(ResultSlot, OutData); };
+    }
+
+    // Two windows, the next one is decoded on workers while the current one is inferred
+    TArray<FSlot> Windows[2];
+    Windows[0].SetNum(WindowSize);
+    Windows[1].SetNum(WindowSize);
+
+    const double Started = FPlatformTime::Seconds();
+    uint64 NumImages = 0;
+
+    int32 Current = 0;
+    int32 NumCurrent = FillWindow(Windows[0]);
+    DecodeWindow(Windows[0], NumCurrent);
+
+    while (NumCurrent > 0)
+    {
+        const int32 Next = 1 - Current;
+        const int32 NumNext = FillWindow(Windows[Next]);
+        TFuture<void> Decoding = Async(EAsyncExecution::ThreadPool, [this, &Windows, Next, NumNext]()
+            {
+                DecodeWindow(Windows[Next], NumNext);
+            });
+
+        InferWindow(Windows[Current], NumCurrent);
+        WriteWindow(Windows[Current], NumCurrent);
+        NumImages += NumCurrent;
+
+        Decoding.Wait();
+        Current = Next;
+        NumCurrent = NumNext;
+
+        UE_LOG(LogNeuralNetwork, Display, TEXT("%llu images, %.1f images/s"), NumImages, NumImages / FMath::Max(FPlatformTime::Seconds() - Started, 1e-6));
+    }
+
+    Output->Close();
+    Output.Reset();
+
+    const double Elapsed = FPlatformTime::Seconds() - Started;
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    UE_LOG(LogNeuralNetwork, Display, TEXT("Batch inference done: %llu images in %.2f s, %.1f images/s, peak memory %.1f MB, predictions in %s"),
+        NumImages, Elapsed, Elapsed > 0.0 ? NumImages / Elapsed : 0.0, MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0), *OutputPath);
+
+    return 0;
+}
+
+
+// Image files take one slot each, raw record files are read one record per slot, sequentially on the game thread.
+int32 UNeuralNetworkBatchInferenceCommandlet::FillWindow(TArray<FSlot>& Window)
+{
+    const int32 RecordSize = RawWidth * RawHeight * RawChannels;
+    int32 NumFilled = 0;
+
+    while (NumFilled < Window.Num() && Pass < NumPasses)
+    {
+        if (FileIdx >= Files.Num())
+        {
+            FileIdx = 0;
+            Pass++;
+            continue;
+        }
+
+        const FString& Path = Files[FileIdx];
+        FSlot& Slot = Window[NumFilled];
+
+        if (!IsRawRecordFile(Path))
+        {
+            Slot.Index = NextIndex++;
+            Slot.Name = FPaths::GetCleanFilename(Path);
+            Slot.Path = Path;
+            Slot.RawBytes.Reset();
+            NumFilled++;
+            FileIdx++;
+            continue;
+        }
+
+        if (!RawReader.IsValid())
+        {
+            RawReader.Reset(IFileManager::Get().CreateFileReader(*Path));
+            RecordsLeftInFile = RawReader.IsValid() ? FMath::Max<int64>(0, RawReader->TotalSize() - RawHeader) / RecordSize : 0;
+            RecordIdx = 0;
+            if (RawReader.IsValid())
+            {
+                RawReader->Seek(RawHeader);
+            }
+        }
+
+        if (RecordsLeftInFile <= 0)
+        {
+            RawReader.Reset();
+            FileIdx++;
+            continue;
+        }
+
+        Slot.Index = NextIndex++;
+        Slot.Name = FString::Printf(TEXT("%s#%lld"), *FPaths::GetCleanFilename(Path), RecordIdx);
+        Slot.Path.Reset();
+        Slot.RawBytes.SetNumUninitialized(RecordSize, false);
+        RawReader->Serialize(Slot.RawBytes.GetData(), RecordSize);
+        RecordsLeftInFile--;
+        RecordIdx++;
+        NumFilled++;
+    }
+
+    return NumFilled;
+}
+
+
+// Each slot decodes into its own pixels and preprocesses into its reused input buffer.
+void UNeuralNetworkBatchInferenceCommandlet::DecodeWindow(TArray<FSlot>& Window, int32 NumSlots)
+{
+    ParallelFor(NumSlots, [this, &Window](int32 SlotIdx)
+        {
+            FSlot& Slot = Window[SlotIdx];
+            Slot.bValid = false;
+
+            TArray<FColor> Pixels;
+            int32 SrcWidth = 0;
+            int32 SrcHeight = 0;
+
+            if (!Slot.Path.IsEmpty())
+            {
+                FImage Image;
+                if (!FImageUtils::LoadImage(*Slot.Path, Image))
+                {
+                    UE_LOG(LogNeuralNetwork, Warning, TEXT("Could not decode %s"), *Slot.Path);
+                    return;
+                }
+
+                Image.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+                const TArrayView64<FColor> Colors = Image.AsBGRA8();
+                Pixels.Append(Colors.GetData(), static_cast<int32>(Colors.Num()));
+                SrcWidth = Image.SizeX;
+                SrcHeight = Image.SizeY;
+            }
+            else
+            {
+                SrcWidth = RawWidth;
+                SrcHeight = RawHeight;
+                Pixels.SetNumUninitialized(RawWidth * RawHeight);
+
+                const uint8* Bytes = Slot.RawBytes.GetData();
+                for (int32 PixelIdx = 0; PixelIdx < Pixels.Num(); ++PixelIdx)
+                {
+                    const uint8* Pixel = Bytes + PixelIdx * RawChannels;
+                    Pixels[PixelIdx] = RawChannels == 1 ? FColor(Pixel[0], Pixel[0], Pixel[0]) : FColor(Pixel[0], Pixel[1], Pixel[2], RawChannels == 4 ? Pixel[3] : 255);
+                }
+            }
+
+            Network->PreProcessImage(Pixels, SrcHeight, SrcWidth, Height, Width, Normalization, Slot.Input);
+            Slot.bValid = Slot.Input.Num() > 0;
+        });
+}
+
+
+void UNeuralNetworkBatchInferenceCommandlet::InferWindow(TArray<FSlot>& Window, int32 NumSlots)
+{
+    InFlight = &Window;
+    NumCompleted = 0;
+
+    int32 NumSubmitted = 0;
+    for (int32 SlotIdx = 0; SlotIdx < NumSlots; ++SlotIdx)
+    {
+        FSlot& Slot = Window[SlotIdx];
+        Slot.Classes.Reset();
+        Slot.Scores.Reset();
+
+        if (Slot.bValid)
+        {
+            FNNEAsyncInferenceDelegate Delegate;
+            Delegate.BindUFunction(Sinks[SlotIdx], GET_FUNCTION_NAME_CHECKED(UNeuralNetworkBatchInferenceSink, HandleResult));
+            if (Network->EnqueueBatchedInference(Slot.Input, Delegate))
+            {
+                NumSubmitted++;
+            }
+        }
+    }
+
+    // Nothing ticks the actor in a commandlet, partial batches are flushed here.
+    // Results are posted right after an instance is freed, so the queue has to stay drained and every instance idle
+    // for a few passes before the missing results count as lost.
+    int32 NumIdlePasses = 0;
+    while (NumCompleted < NumSubmitted)
+    {
+        Network->FlushBatchedInference();
+        const bool bIdle = Network->GetNumPendingBatchedRequests() == 0 && Network->GetNumIdleModelInstances() == Network->GetNumModelInstances();
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+        NumIdlePasses = bIdle ? NumIdlePasses + 1 : 0;
+        if (NumIdlePasses > 3 && NumCompleted < NumSubmitted)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("%d of %d images got no result"), NumSubmitted - NumCompleted, NumSubmitted);
+            break;
+        }
+
+        FPlatformProcess::Sleep(bIdle ? 0.001f : 0.0f);
+    }
+
+    InFlight = nullptr;
+}
+
+
+// Reduces on the game thread, the output of one image is small next to its preprocessing.
+void UNeuralNetworkBatchInferenceCommandlet::HandleResult(int32 Slot, const TArray<float>& OutData)
+{
+    NumCompleted++;
+
+    if (!InFlight || !InFlight->IsValidIndex(Slot))
+    {
+        return;
+    }
+
+    const uint32 Shape[] = { 1, static_cast<uint32>(OutData.Num()) };
+    FNNEClassificationResult Result;
+    if (FNeuralNetworkPostProcessing::Process(OutData, MakeArrayView(Shape), Reduction, Result))
+    {
+        (*InFlight)[Slot].Classes = MoveTemp(Result.ClassIndices);
+        (*InFlight)[Slot].Scores = MoveTemp(Result.Scores);
+    }
+}
+
+
+// Missing classes, e.g. for images that failed to decode, are written as -1 with a score of 0.
+void UNeuralNetworkBatchInferenceCommandlet::WriteWindow(const TArray<FSlot>& Window, int32 NumSlots)
+{
+    const int32 TopK = Reduction.TopK;
+    FString Lines;
+
+    for (int32 SlotIdx = 0; SlotIdx < NumSlots; ++SlotIdx)
+    {
+        const FSlot& Slot = Window[SlotIdx];
+
+        if (bBinaryOutput)
+        {
+            uint64 Index = Slot.Index;
+            *Output << Index;
+            for (int32 Rank = 0; Rank < TopK; ++Rank)
+            {
+                int32 ClassIdx = Slot.Classes.IsValidIndex(Rank) ? Slot.Classes[Rank] : INDEX_NONE;
+                *Output << ClassIdx;
+            }
+            for (int32 Rank = 0; Rank < TopK; ++Rank)
+            {
+                float Score = Slot.Scores.IsValidIndex(Rank) ? Slot.Scores[Rank] : 0.0f;
+                *Output << Score;
+            }
+            continue;
+        }
+
+        Lines += Slot.Name;
+        for (int32 Rank = 0; Rank < TopK; ++Rank)
+        {
+            Lines += FString::Printf(TEXT(",%d,%.6f"), Slot.Classes.IsValidIndex(Rank) ? Slot.Classes[Rank] : INDEX_NONE, Slot.Scores.IsValidIndex(Rank) ? Slot.Scores[Rank] : 0.0f);
+        }
+        Lines += TEXT("\n");
+    }
+
+    if (!bBinaryOutput)
+    {
+        WriteUTF8(*Output, Lines);
+    }
+}
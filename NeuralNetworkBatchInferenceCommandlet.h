@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NeuralNetworkPreProcessing.h"
+#include "NeuralNetworkPostProcessing.h"
+
+#include "NeuralNetworkBatchInferenceCommandlet.generated.h"
+
+class ANeuralNetwork;
+
+// Routes one in-flight request's result back to its window slot, dynamic delegates carry no payload of their own
+UCLASS()
+class AI_PLAYGROUND_API UNeuralNetworkBatchInferenceSink : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    int32 Slot = 0;
+    TFunction<void(int32, const TArray<float>&)> OnResult;
+
+    UFUNCTION()
+    void HandleResult(const TArray<float>& OutData)
+    {
+        OnResult(Slot, OutData);
+    }
+};
+
+/**
+ * Headless batch inference over a directory of images with the ANeuralNetwork preprocessing and batched inference,
+ * for offline evaluation and dataset labelling. Images are streamed in windows, one window is decoded and preprocessed
+ * in parallel while the previous one is inferred, so memory stays bounded whatever the dataset size.
+ *
+ * UnrealEditor-Cmd <Project> -run=NeuralNetworkBatchInference -nullrhi
+ *     -Model=/Game/Models/mnist-8.mnist-8   model asset
+ *     -Input=<dir>                          PNG, JPEG, BMP or EXR images and raw record files, read recursively in name order
+ *     -Output=<file.csv|file.bin>           CSV lines or compact binary records, defaults to Saved/NeuralNetworkPredictions.csv
+ *     -Repeat=1                             passes over the dataset
+ *     -Window=256                           images decoded and in flight at once
+ *     -BatchSize=8                          MaxBatchSize, only used when the model's batch dimension is variable
+ *     -Instances=2                          NumModelInstances
+ *     -TopK=1                               classes written per image
+ *     -NHWC                                 channels last input layout
+ *     -RawWidth=28 -RawHeight=28 -RawChannels=1 -RawHeader=16
+ *                                           .raw and *ubyte files hold fixed size 8-bit records after a header, e.g. the MNIST idx files
+ *
+ * Binary output is a 'NNEP' magic, version and TopK as uint32, then per image a uint64 index, TopK int32 classes
+ * and TopK float scores. Images per second and peak memory are logged at the end.
+ */
+UCLASS()
+class AI_PLAYGROUND_API UNeuralNetworkBatchInferenceCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UNeuralNetworkBatchInferenceCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // One image of a window, buffers are reused from window to window
+    struct FSlot
+    {
+        uint64 Index = 0;
+        FString Name;
+        FString Path;
+        TArray<uint8> RawBytes;
+        TArray<float> Input;
+        TArray<int32> Classes;
+        TArray<float> Scores;
+        bool bValid = false;
+    };
+
+    // Fills the window with the next records of the dataset, returns how many
+    int32 FillWindow(TArray<FSlot>& Window);
+
+    // Decodes and preprocesses every slot of the window in parallel
+    void DecodeWindow(TArray<FSlot>& Window, int32 NumSlots);
+
+    // Submits the window for batched inference and pumps the game thread until every result is in
+    void InferWindow(TArray<FSlot>& Window, int32 NumSlots);
+
+    void WriteWindow(const TArray<FSlot>& Window, int32 NumSlots);
+
+    void HandleResult(int32 Slot, const TArray<float>& OutData);
+
+    UPROPERTY(Transient)
+    TObjectPtr<ANeuralNetwork> Network;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UNeuralNetworkBatchInferenceSink>> Sinks;
+
+    // Dataset cursor
+    TArray<FString> Files;
+    int32 NumPasses = 1;
+    int32 Pass = 0;
+    int32 FileIdx = 0;
+    TUniquePtr<FArchive> RawReader;
+    int64 RecordsLeftInFile = 0;
+    int64 RecordIdx = 0;
+    uint64 NextIndex = 0;
+
+    // Raw record format
+    int32 RawWidth = 28;
+    int32 RawHeight = 28;
+    int32 RawChannels = 1;
+    int32 RawHeader = 16;
+
+    // Model input
+    int32 Height = 0;
+    int32 Width = 0;
+    FNNEImageNormalization Normalization;
+    FNNEPostProcessSettings Reduction;
+
+    TArray<FSlot>* InFlight = nullptr;
+    int32 NumCompleted = 0;
+
+    TUniquePtr<FArchive> Output;
+    bool bBinaryOutput = false;
+};
@@ -0,0 +1,593 @@
+#include "NeuralNetworkBenchmarkCommandlet.h"
+#include "NeuralNetwork.h"
+#include "NeuralNetworkCaptureSource.h"
+#include "NeuralNetworkStats.h"
+#include "ImageUtils.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "HAL/PlatformMisc.h"
+#include "Async/ParallelFor.h"
+
+
+namespace
+{
+    // Parses "1,4,8" into integers, keeping Defaults when the switch is absent
+    TArray<int32> ParseIntList(const FString& Params, const TCHAR* Switch, TArray<int32> Defaults)
+    {
+        FString Value;
+        if (!FParse::Value(*Params, Switch, Value))
+        {
+            return Defaults;
+        }
+
+        TArray<FString> Items;
+        Value.ParseIntoArray(Items, TEXT(","));
+
+        TArray<int32> Parsed;
+        for (const FString& Item : Items)
+        {
+            Parsed.Add(FMath::Max(1, FCString::Atoi(*Item)));
+        }
+        return Parsed.Num() > 0 ? Parsed : Defaults;
+    }
+
+    // The original RT2PixelBuffer -> ResizeImage -> NormalizeImage chain, kept as the baseline for the new kernels
+    void LegacyPreProcess(const TArray<FColor>& Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, TArray<float>& FlatImg)
+    {
+        TArray<FLinearColor> LinearColorArray;
+        LinearColorArray.SetNumUninitialized(SrcWidth * SrcHeight);
+        ParallelFor(SrcWidth * SrcHeight, [&](int32 Idx)
+            {
+                LinearColorArray[Idx] = FLinearColor(Pixels[Idx]);
+            });
+
+        TArray<FLinearColor> Resized;
+        Resized.SetNumZeroed(DstWidth * DstHeight);
+        FImageUtils::ImageResize(SrcWidth, SrcHeight, LinearColorArray, DstWidth, DstHeight, Resized);
+
+        FCriticalSection Mutex;
+        TArray<float> Temp;
+        Temp.SetNumZeroed(Resized.Num());
+        ParallelFor(Resized.Num(), [&](int32 Idx)
+            {
+                const float GrayValue = FMath::Lerp(Resized[Idx].R, FMath::Lerp(Resized[Idx].G, Resized[Idx].B, 0.33f), 0.33f);
+                FScopeLock Lock(&Mutex);
+                Temp[Idx] = GrayValue;
+            });
+
+        FlatImg = Temp;
+    }
+}
+
+
+UNeuralNetworkBenchmarkCommandlet::UNeuralNetworkBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+
+int32 UNeuralNetworkBenchmarkCommandlet::Main(const FString& Params)
+{
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Requests="), Requests);
+    Iterations = FMath::Max(1, Iterations);
+    Requests = FMath::Max(1, Requests);
+
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("NeuralNetworkBenchmark.json");
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    FString ModelPath;
+    FParse::Value(*Params, TEXT("Model="), ModelPath);
+
+    TArray<FIntPoint> Resolutions;
+    {
+        FString ResolutionList = TEXT("640x480,1920x1080");
+        FParse::Value(*Params, TEXT("Resolutions="), ResolutionList);
+
+        TArray<FString> Items;
+        ResolutionList.ParseIntoArray(Items, TEXT(","));
+        for (const FString& Item : Items)
+        {
+            FString Width, Height;
+            if (Item.Split(TEXT("x"), &Width, &Height))
+            {
+                Resolutions.Emplace(FMath::Max(1, FCString::Atoi(*Width)), FMath::Max(1, FCString::Atoi(*Height)));
+            }
+        }
+    }
+
+    const TArray<int32> BatchSizes = ParseIntList(Params, TEXT("BatchSizes="), { 1, 4, 8 });
+    const TArray<int32> InstanceCounts = ParseIntList(Params, TEXT("Instances="), { 1, 2, 4, 8 });
+    const TArray<int32> ProducerCounts = ParseIntList(Params, TEXT("Producers="), { 1, 4, 8 });
+
+    UNNEModelData* ModelData = nullptr;
+    if (!ModelPath.IsEmpty())
+    {
+        ModelData = TSoftObjectPtr<UNNEModelData>(FSoftObjectPath(ModelPath)).LoadSynchronous();
+        if (!ModelData)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Could not load model %s"), *ModelPath);
+            return 1;
+        }
+    }
+
+    // Without a model the stages are still timed at mnist-8's input size
+    int32 Height = 28;
+    int32 Width = 28;
+    int32 ColorChannels = 1;
+    ANeuralNetwork* Network = ModelData ? CreateNetwork(ModelData, 1, Height, Width, ColorChannels) : NewObject<ANeuralNetwork>(GetTransientPackage());
+    if (!Network)
+    {
+        return 1;
+    }
+
+    for (const FIntPoint& Resolution : Resolutions)
+    {
+        BenchmarkPreProcessing(Network, Resolution.X, Resolution.Y, Height, Width, ColorChannels);
+    }
+
+    if (ModelData)
+    {
+        // Synthetic input, the values only matter for the model's numerics, not its timing
+        TArray<float> InputData;
+        InputData.SetNumUninitialized(Height * Width * ColorChannels);
+        for (int32 Idx = 0; Idx < InputData.Num(); ++Idx)
+        {
+            InputData[Idx] = (Idx % 17) / 16.0f;
+        }
+
+        BenchmarkTimeToFirstInference(ModelData, InputData);
+
+        for (int32 NumInstances : InstanceCounts)
+        {
+            ANeuralNetwork* PoolNetwork = CreateNetwork(ModelData, NumInstances, Height, Width, ColorChannels);
+            if (PoolNetwork)
+            {
+                BenchmarkInference(PoolNetwork, TEXT("RunAsyncInference"), NumInstances, 1, InputData);
+            }
+
+            // Same pool on dedicated threads, one per instance, instead of the task graph workers
+            ANeuralNetwork* ExecutorNetwork = CreateNetwork(ModelData, NumInstances, Height, Width, ColorChannels);
+            if (ExecutorNetwork)
+            {
+                ExecutorNetwork->InferenceThreads = NumInstances;
+                BenchmarkInference(ExecutorNetwork, TEXT("RunAsyncInferenceExecutor"), NumInstances, 1, InputData);
+            }
+        }
+
+        for (int32 BatchSize : BatchSizes)
+        {
+            BenchmarkInference(Network, TEXT("EnqueueBatchedInference"), 1, BatchSize, InputData);
+        }
+
+        // Producers share the largest pool, so the numbers show submission contention rather than a lack of instances
+        const int32 ProducerInstances = FMath::Max(1, FMath::Max(InstanceCounts));
+        for (int32 NumProducers : ProducerCounts)
+        {
+            ANeuralNetwork* ProducerNetwork = CreateNetwork(ModelData, ProducerInstances, Height, Width, ColorChannels);
+            if (ProducerNetwork)
+            {
+                BenchmarkProducers(ProducerNetwork, ProducerInstances, FMath::Max(1, NumProducers), InputData);
+            }
+        }
+    }
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetStringField(TEXT("engine"), FEngineVersion::Current().ToString());
+    Root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand());
+    Root->SetNumberField(TEXT("logical_cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    Root->SetStringField(TEXT("model"), ModelPath);
+    Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Root->SetArrayField(TEXT("results"), Results);
+
+    FString Json;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not write benchmark results to %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("Wrote %d benchmark results to %s"), Results.Num(), *OutputPath);
+    return 0;
+}
+
+
+// Same setup sequence a Blueprint user runs after OnModelDataLoaded.
+ANeuralNetwork* UNeuralNetworkBenchmarkCommandlet::CreateNetwork(UNNEModelData* ModelData, int32 NumInstances, int32& OutHeight, int32& OutWidth, int32& OutColorChannels)
+{
+    ANeuralNetwork* Network = NewObject<ANeuralNetwork>(GetTransientPackage());
+    Network->LazyLoadedModelData = ModelData;
+    Network->NumModelInstances = NumInstances;
+
+    if (!Network->CreateCPUModel())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not create the model with %d instances"), NumInstances);
+        return nullptr;
+    }
+
+    return BindNetwork(Network, OutHeight, OutWidth, OutColorChannels) ? Network : nullptr;
+}
+
+
+bool UNeuralNetworkBenchmarkCommandlet::BindNetwork(ANeuralNetwork* Network, int32& OutHeight, int32& OutWidth, int32& OutColorChannels)
+{
+    int32 NumInputs, InputIdx, Rank, Volume, Dimension, Frame, PredOpts;
+    Network->GetInputTensorDescs(false, NumInputs, InputIdx);
+    Network->GetInputTensorShape(0, false, Rank, Volume, Dimension, Frame, OutColorChannels, OutHeight, OutWidth);
+    Network->GetOutputTensorDescs(false);
+    Network->GetOutputTensorShape(0, false, Rank, Volume, Dimension, PredOpts);
+
+    bool bInSuccess = false;
+    bool bOutSuccess = false;
+    Network->CreateInputTensorBinding(false, bInSuccess);
+    Network->CreateOutputTensorBinding(false, bOutSuccess);
+
+    return bInSuccess && bOutSuccess;
+}
+
+
+void UNeuralNetworkBenchmarkCommandlet::BenchmarkTimeToFirstInference(UNNEModelData* ModelData, const TArray<float>& InputData)
+{
+    FNNEAsyncInferenceDelegate Delegate;
+    Delegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UNeuralNetworkBenchmarkCommandlet, OnInferenceComplete));
+
+    // Private models measure a cold creation, the shared case picks up the model the earlier networks left in the registry
+    for (int32 CaseIdx = 0; CaseIdx < 4; ++CaseIdx)
+    {
+        const bool bShared = CaseIdx >= 2;
+        const bool bAsync = CaseIdx % 2 == 1;
+
+        ANeuralNetwork* Network = NewObject<ANeuralNetwork>(GetTransientPackage());
+        Network->LazyLoadedModelData = ModelData;
+        Network->bUseSharedModelRegistry = bShared;
+
+        // Game thread time spent inside the creation call is the hitch a level load would see
+        const double Started = FPlatformTime::Seconds();
+        if (bAsync)
+        {
+            Network->CreateCPUModelAsync();
+        }
+        else
+        {
+            Network->CreateCPUModel();
+        }
+        const double Blocked = FPlatformTime::Seconds() - Started;
+
+        while (Network->IsModelCreationPending())
+        {
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+            FPlatformProcess::Sleep(0.001f);
+        }
+        const double Ready = FPlatformTime::Seconds() - Started;
+
+        int32 Height, Width, ColorChannels;
+        if (!Network->IsModelReady() || !BindNetwork(Network, Height, Width, ColorChannels))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Could not create the model for the time to first inference case"));
+            continue;
+        }
+
+        CompletedInferences = 0;
+        const double FirstStarted = FPlatformTime::Seconds();
+        Network->RunAsyncInference(true, true, InputData, Delegate);
+        WaitForCompletions(1);
+        const double Finished = FPlatformTime::Seconds();
+
+        TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetStringField(TEXT("stage"), TEXT("TimeToFirstInference"));
+        Result->SetStringField(TEXT("creation"), bAsync ? TEXT("CreateCPUModelAsync") : TEXT("CreateCPUModel"));
+        Result->SetBoolField(TEXT("shared_model"), bShared);
+        Result->SetNumberField(TEXT("warm_up_runs"), bAsync ? Network->NumWarmUpRuns : 0);
+        Result->SetNumberField(TEXT("game_thread_blocked_ms"), Blocked * 1000.0);
+        Result->SetNumberField(TEXT("model_ready_ms"), Ready * 1000.0);
+        Result->SetNumberField(TEXT("first_inference_ms"), (Finished - FirstStarted) * 1000.0);
+        Result->SetNumberField(TEXT("time_to_first_inference_ms"), (Finished - Started) * 1000.0);
+        Results.Add(MakeShared<FJsonValueObject>(Result));
+
+        UE_LOG(LogNeuralNetwork, Display, TEXT("TimeToFirstInference %s%s: blocked %.3f ms, first inference %.3f ms, total %.3f ms"), bAsync ? TEXT("async") : TEXT("sync"), bShared ? TEXT(" shared") : TEXT(""), Blocked * 1000.0, (Finished - FirstStarted) * 1000.0, (Finished - Started) * 1000.0);
+    }
+}
+
+
+void UNeuralNetworkBenchmarkCommandlet::BenchmarkPreProcessing(ANeuralNetwork* Network, int32 CaptureWidth, int32 CaptureHeight, int32 Height, int32 Width, int32 ColorChannels)
+{
+    FSyntheticCaptureSource Source(CaptureWidth, CaptureHeight);
+    TArray<FColor> Pixels;
+    int32 SrcWidth = 0;
+    int32 SrcHeight = 0;
+    Source.RequestCapture();
+    Source.TryGetCapture(Pixels, SrcWidth, SrcHeight);
+
+    FNNEImageNormalization Normalization = Network->InputNormalization;
+    Normalization.ColorChannels = ColorChannels;
+
+    TArray<FLinearColor> Resized;
+    TArray<float> FlatImg;
+    int32 ResizedHeight = 0;
+    int32 ResizedWidth = 0;
+
+    auto MakeCase = [&]()
+        {
+            TSharedRef<FJsonObject> Case = MakeShared<FJsonObject>();
+            Case->SetNumberField(TEXT("capture_width"), CaptureWidth);
+            Case->SetNumberField(TEXT("capture_height"), CaptureHeight);
+            Case->SetNumberField(TEXT("width"), Width);
+            Case->SetNumberField(TEXT("height"), Height);
+            Case->SetNumberField(TEXT("channels"), ColorChannels);
+            return Case;
+        };
+
+    auto TimeStage = [this](TFunctionRef<void()> Stage)
+        {
+            TArray<double> Samples;
+            Samples.Reserve(Iterations);
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                const double Started = FPlatformTime::Seconds();
+                Stage();
+                Samples.Add(FPlatformTime::Seconds() - Started);
+            }
+            return Samples;
+        };
+
+    TArray<double> Samples = TimeStage([&]() { LegacyPreProcess(Pixels, SrcWidth, SrcHeight, Width, Height, FlatImg); });
+    AddResult(TEXT("LegacyPreProcess"), Samples, MakeCase());
+
+    Samples = TimeStage([&]() { Network->ResizeImage(Pixels, SrcHeight, SrcWidth, Height, Width, Resized, ResizedHeight, ResizedWidth); });
+    AddResult(TEXT("ResizeImage"), Samples, MakeCase());
+
+    Samples = TimeStage([&]() { Network->NormalizeImage(Resized, ColorChannels, FlatImg); });
+    AddResult(TEXT("NormalizeImage"), Samples, MakeCase());
+
+    Samples = TimeStage([&]() { Network->PreProcessImage(Pixels, SrcHeight, SrcWidth, Height, Width, Normalization, FlatImg); });
+    AddResult(TEXT("PreProcessImage"), Samples, MakeCase());
+
+    // Same pass storing the input types of fp16 and quantized models, the tensor is 2x and 4x smaller
+    TArray<FFloat16> HalfImg;
+    HalfImg.SetNumUninitialized(Height * Width * ColorChannels);
+    Samples = TimeStage([&]() { FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, Width, Height, Network->ResizeFilter, Normalization, HalfImg); });
+    AddResult(TEXT("PreProcessImageHalf"), Samples, MakeCase());
+
+    FNNEImageNormalization ByteNormalization = Normalization;
+    ByteNormalization.bSRGBToLinear = false;
+    ByteNormalization.InputScale = 255.0f;
+    ByteNormalization.Mean = FVector3f::ZeroVector;
+    ByteNormalization.Std = FVector3f::OneVector;
+
+    TArray<uint8> ByteImg;
+    ByteImg.SetNumUninitialized(Height * Width * ColorChannels);
+    Samples = TimeStage([&]() { FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, Width, Height, Network->ResizeFilter, ByteNormalization, ByteImg); });
+    AddResult(TEXT("PreProcessImageUInt8"), Samples, MakeCase());
+
+    // Glue between two cascade stages, cropping the center of a full resolution tensor down to the second model's input
+    TArray<float> CaptureTensor;
+    CaptureTensor.SetNumUninitialized(SrcHeight * SrcWidth * ColorChannels);
+    FNeuralNetworkPreProcessing::PixelsToTensor(Pixels, SrcWidth, SrcHeight, SrcWidth, SrcHeight, Network->ResizeFilter, Normalization, CaptureTensor);
+    const TArray<int32> CaptureShape = { 1, ColorChannels, SrcHeight, SrcWidth };
+
+    TArray<float> Cropped;
+    TArray<float> CascadeResized;
+    TArray<float> CascadeNormalized;
+    TArray<int32> CroppedShape;
+    TArray<int32> ResizedShape;
+    Samples = TimeStage([&]()
+        {
+            FNeuralNetworkCascadeOps::Crop(CaptureTensor, CaptureShape, SrcWidth / 4, SrcHeight / 4, SrcWidth / 2, SrcHeight / 2, Cropped, CroppedShape);
+            FNeuralNetworkCascadeOps::Resize(Cropped, CroppedShape, Width, Height, CascadeResized, ResizedShape);
+            FNeuralNetworkCascadeOps::Normalize(CascadeResized, ResizedShape, 1.0f, Normalization.Mean, Normalization.Std, CascadeNormalized);
+        });
+    AddResult(TEXT("CascadeGlueOps"), Samples, MakeCase());
+}
+
+
+void UNeuralNetworkBenchmarkCommandlet::BenchmarkInference(ANeuralNetwork* Network, const TCHAR* Stage, int32 NumInstances, int32 BatchSize, const TArray<float>& InputData)
+{
+    FNNEAsyncInferenceDelegate Delegate;
+    Delegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UNeuralNetworkBenchmarkCommandlet, OnInferenceComplete));
+
+    const bool bBatched = FCString::Strcmp(Stage, TEXT("EnqueueBatchedInference")) == 0;
+    Network->MaxBatchSize = BatchSize;
+
+    // One warm-up inference keeps first-run initialization out of the numbers
+    CompletedInferences = 0;
+    Network->RunAsyncInference(true, true, InputData, Delegate);
+    WaitForCompletions(1);
+    Network->ResetLatencyStats();
+
+    CompletedInferences = 0;
+    const double Started = FPlatformTime::Seconds();
+
+    for (int32 Submitted = 0; Submitted < Requests; )
+    {
+        if (bBatched)
+        {
+            if (!Network->EnqueueBatchedInference(InputData, Delegate))
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Skipping %s, the model cannot be batched"), Stage);
+                return;
+            }
+            Submitted++;
+        }
+        else if (Network->GetNumIdleModelInstances() > 0)
+        {
+            Network->RunAsyncInference(true, true, InputData, Delegate);
+            Submitted++;
+        }
+        else
+        {
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        }
+    }
+
+    if (bBatched)
+    {
+        while (CompletedInferences < Requests)
+        {
+            Network->FlushBatchedInference();
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        }
+    }
+    WaitForCompletions(Requests);
+
+    const double Elapsed = FPlatformTime::Seconds() - Started;
+
+    float P50Ms, P95Ms, P99Ms, InferencesPerSecond;
+    Network->GetInferenceLatencyStats(P50Ms, P95Ms, P99Ms, InferencesPerSecond);
+
+    float RunP50Ms, RunP95Ms, RunP99Ms, RunsPerSecond;
+    Network->GetRunSyncLatencyStats(RunP50Ms, RunP95Ms, RunP99Ms, RunsPerSecond);
+
+    TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("stage"), Stage);
+    Result->SetNumberField(TEXT("instances"), NumInstances);
+    Result->SetNumberField(TEXT("batch_size"), BatchSize);
+    Result->SetNumberField(TEXT("requests"), Requests);
+    Result->SetNumberField(TEXT("p50_ms"), P50Ms);
+    Result->SetNumberField(TEXT("p95_ms"), P95Ms);
+    Result->SetNumberField(TEXT("p99_ms"), P99Ms);
+    Result->SetNumberField(TEXT("runsync_p50_ms"), RunP50Ms);
+    Result->SetNumberField(TEXT("runsync_p99_ms"), RunP99Ms);
+    Result->SetNumberField(TEXT("throughput_per_s"), Elapsed > 0.0 ? Requests / Elapsed : 0.0);
+    Results.Add(MakeShared<FJsonValueObject>(Result));
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("%s instances=%d batch=%d: p50 %.3f ms, p99 %.3f ms, %.1f/s"), Stage, NumInstances, BatchSize, P50Ms, P99Ms, Elapsed > 0.0 ? Requests / Elapsed : 0.0);
+}
+
+
+// Every request is queued rather than dropped, the game thread admits them while the producers are still submitting.
+void UNeuralNetworkBenchmarkCommandlet::BenchmarkProducers(ANeuralNetwork* Network, int32 NumInstances, int32 NumProducers, const TArray<float>& InputData)
+{
+    Network->AdmissionPolicy = ENNEAdmissionPolicy::BoundedQueue;
+    Network->MaxQueuedRequests = Requests;
+    Network->ResetLatencyStats();
+
+    TArray<TArray<FNeuralNetworkRequestRef>> Issued;
+    Issued.SetNum(NumProducers);
+    std::atomic<int32> NumProducersDone{ 0 };
+
+    const double Started = FPlatformTime::Seconds();
+
+    for (int32 Producer = 0; Producer < NumProducers; ++Producer)
+    {
+        const int32 Count = Requests / NumProducers + (Producer < Requests % NumProducers ? 1 : 0);
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Network, &InputData, &Issued, &NumProducersDone, Producer, Count]()
+            {
+                Issued[Producer].Reserve(Count);
+                for (int32 Idx = 0; Idx < Count; ++Idx)
+                {
+                    Issued[Producer].Add(Network->EnqueueInference({ InputData }));
+                }
+                NumProducersDone++;
+            });
+    }
+
+    // Producers only touch their own array, it is read once every producer has finished
+    auto AllFinished = [&]()
+        {
+            if (NumProducersDone < NumProducers)
+            {
+                return false;
+            }
+            for (const TArray<FNeuralNetworkRequestRef>& ProducerRequests : Issued)
+            {
+                for (const FNeuralNetworkRequestRef& Request : ProducerRequests)
+                {
+                    if (!Request->IsDone())
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+    while (!AllFinished())
+    {
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        FPlatformProcess::Sleep(0.0f);
+    }
+
+    const double Elapsed = FPlatformTime::Seconds() - Started;
+
+    int32 NumCompleted = 0;
+    for (const TArray<FNeuralNetworkRequestRef>& ProducerRequests : Issued)
+    {
+        for (const FNeuralNetworkRequestRef& Request : ProducerRequests)
+        {
+            NumCompleted += Request->GetStatus() == ENNERequestStatus::Completed ? 1 : 0;
+        }
+    }
+
+    float P50Ms, P95Ms, P99Ms, InferencesPerSecond;
+    Network->GetInferenceLatencyStats(P50Ms, P95Ms, P99Ms, InferencesPerSecond);
+
+    TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("stage"), TEXT("EnqueueInference"));
+    Result->SetNumberField(TEXT("instances"), NumInstances);
+    Result->SetNumberField(TEXT("producers"), NumProducers);
+    Result->SetNumberField(TEXT("requests"), Requests);
+    Result->SetNumberField(TEXT("completed"), NumCompleted);
+    Result->SetNumberField(TEXT("p50_ms"), P50Ms);
+    Result->SetNumberField(TEXT("p95_ms"), P95Ms);
+    Result->SetNumberField(TEXT("p99_ms"), P99Ms);
+    Result->SetNumberField(TEXT("throughput_per_s"), Elapsed > 0.0 ? NumCompleted / Elapsed : 0.0);
+    Results.Add(MakeShared<FJsonValueObject>(Result));
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("EnqueueInference instances=%d producers=%d: %d/%d completed, p50 %.3f ms, p99 %.3f ms, %.1f/s"), NumInstances, NumProducers, NumCompleted, Requests, P50Ms, P99Ms, Elapsed > 0.0 ? NumCompleted / Elapsed : 0.0);
+}
+
+
+void UNeuralNetworkBenchmarkCommandlet::WaitForCompletions(int32 Target)
+{
+    while (CompletedInferences < Target)
+    {
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        FPlatformProcess::Sleep(0.0f);
+    }
+}
+
+
+void UNeuralNetworkBenchmarkCommandlet::OnInferenceComplete(const TArray<float>& OutData)
+{
+    CompletedInferences++;
+}
+
+
+// Summarizes the samples of one stage into the results array.
+void UNeuralNetworkBenchmarkCommandlet::AddResult(const FString& Stage, TArray<double>& SamplesSeconds, TSharedRef<FJsonObject> Case)
+{
+    SamplesSeconds.Sort();
+
+    double Total = 0.0;
+    for (double Sample : SamplesSeconds)
+    {
+        Total += Sample;
+    }
+
+    auto PercentileMs = [&SamplesSeconds](double Fraction)
+        {
+            const int32 Idx = FMath::Clamp(FMath::CeilToInt32(Fraction * SamplesSeconds.Num()) - 1, 0, SamplesSeconds.Num() - 1);
+            return SamplesSeconds[Idx] * 1000.0;
+        };
+
+    const double MeanMs = Total * 1000.0 / FMath::Max(1, SamplesSeconds.Num());
+
+    Case->SetStringField(TEXT("stage"), Stage);
+    Case->SetNumberField(TEXT("iterations"), SamplesSeconds.Num());
+    Case->SetNumberField(TEXT("mean_ms"), MeanMs);
+    Case->SetNumberField(TEXT("p50_ms"), PercentileMs(0.50));
+    Case->SetNumberField(TEXT("p95_ms"), PercentileMs(0.95));
+    Case->SetNumberField(TEXT("p99_ms"), PercentileMs(0.99));
+    Results.Add(MakeShared<FJsonValueObject>(Case));
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("%s: mean %.3f ms, p50 %.3f ms"), *Stage, MeanMs, PercentileMs(0.50));
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "NeuralNetworkBenchmarkCommandlet.generated.h"
+
+class ANeuralNetwork;
+class FJsonObject;
+class UNNEModelData;
+
+/**
+ * Headless benchmark of the ANeuralNetwork pipeline, each stage timed separately and written as JSON.
+ *
+ * UnrealEditor-Cmd <Project> -run=NeuralNetworkBenchmark -nullrhi
+ *     -Model=/Game/Models/mnist-8.mnist-8   model asset, inference stages are skipped without it
+ *     -Output=<file.json>                   defaults to Saved/NeuralNetworkBenchmark.json
+ *     -Iterations=200                       timed iterations per preprocessing case
+ *     -Requests=500                         inferences per inference case
+ *     -Resolutions=640x480,1920x1080        synthetic capture sizes
+ *     -BatchSizes=1,4,8                     MaxBatchSize values for batched inference
+ *     -Instances=1,2,4,8                    NumModelInstances values for concurrent inference
+ *     -Producers=1,4,8                      threads submitting at once through EnqueueInference
+ *
+ * Time to first inference is measured for CreateCPUModel and for CreateCPUModelAsync with warm-up.
+ */
+UCLASS()
+class AI_PLAYGROUND_API UNeuralNetworkBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UNeuralNetworkBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    UFUNCTION()
+    void OnInferenceComplete(const TArray<float>& OutData);
+
+    // Creates a transient network on the model with the given pool size and binds its tensors
+    ANeuralNetwork* CreateNetwork(UNNEModelData* ModelData, int32 NumInstances, int32& OutHeight, int32& OutWidth, int32& OutColorChannels);
+
+    // Reads the tensor shapes of a network with a model and creates its bindings
+    bool BindNetwork(ANeuralNetwork* Network, int32& OutHeight, int32& OutWidth, int32& OutColorChannels);
+
+    // Times model creation plus the first inference, synchronous creation against asynchronous creation with warm-up
+    void BenchmarkTimeToFirstInference(UNNEModelData* ModelData, const TArray<float>& InputData);
+
+    // Times the legacy, split and fused preprocessing paths at one capture resolution
+    void BenchmarkPreProcessing(ANeuralNetwork* Network, int32 CaptureWidth, int32 CaptureHeight, int32 Height, int32 Width, int32 ColorChannels);
+
+    // Submits Requests inferences as fast as the pool accepts them, timing each one to its delegate
+    void BenchmarkInference(ANeuralNetwork* Network, const TCHAR* Stage, int32 NumInstances, int32 BatchSize, const TArray<float>& InputData);
+
+    // Producer threads submit Requests inferences at once through the lock-free queue, timing each one to its completion
+    void BenchmarkProducers(ANeuralNetwork* Network, int32 NumInstances, int32 NumProducers, const TArray<float>& InputData);
+
+    // Runs game thread tasks until the given number of delegates have fired
+    void WaitForCompletions(int32 Target);
+
+    void AddResult(const FString& Stage, TArray<double>& SamplesSeconds, TSharedRef<FJsonObject> Case);
+
+    TArray<TSharedPtr<class FJsonValue>> Results;
+
+    int32 Iterations = 200;
+    int32 Requests = 500;
+    int32 CompletedInferences = 0;
+};
@@ -0,0 +1,194 @@
+#include "NeuralNetworkCaptureSource.h"
+#include "NeuralNetworkStats.h"
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+#include "TextureResource.h"
+
+
+FRenderTargetCaptureSource::FRenderTargetCaptureSource(UTextureRenderTarget2D* InRenderTarget, int32 NumStagingBuffers)
+    : RenderTarget(InRenderTarget)
+{
+    if (InRenderTarget)
+    {
+        const EPixelFormat Format = InRenderTarget->GetFormat();
+        if (Format != PF_B8G8R8A8 && Format != PF_R8G8B8A8)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Capture source only supports 8-bit RGBA render targets, %s uses %s"), *InRenderTarget->GetName(), GetPixelFormatString(Format));
+            RenderTarget.Reset();
+        }
+        bSwapRedBlue = Format == PF_R8G8B8A8;
+    }
+
+    Slots.SetNum(FMath::Max(1, NumStagingBuffers));
+    for (int32 SlotIdx = 0; SlotIdx < Slots.Num(); ++SlotIdx)
+    {
+        Slots[SlotIdx] = MakeShared<FSlot, ESPMode::ThreadSafe>();
+        Slots[SlotIdx]->Readback = MakeUnique<FRHIGPUTextureReadback>(*FString::Printf(TEXT("NeuralNetworkCapture%d"), SlotIdx));
+    }
+}
+
+
+// Enqueues a GPU copy of the render target into a free staging buffer.
+bool FRenderTargetCaptureSource::RequestCapture()
+{
+    UTextureRenderTarget2D* InputRT = RenderTarget.Get();
+    if (!InputRT)
+    {
+        return false;
+    }
+
+    FTextureRenderTargetResource* Resource = InputRT->GameThread_GetRenderTargetResource();
+    if (!Resource)
+    {
+        return false;
+    }
+
+    for (int32 SlotIdx = 0; SlotIdx < Slots.Num(); ++SlotIdx)
+    {
+        TSharedPtr<FSlot, ESPMode::ThreadSafe> Slot = Slots[SlotIdx];
+        if (Slot->State.load(std::memory_order_acquire) != ESlotState::Idle)
+        {
+            continue;
+        }
+
+        Slot->Width = InputRT->SizeX;
+        Slot->Height = InputRT->SizeY;
+        Slot->State.store(ESlotState::Copying, std::memory_order_release);
+        PendingSlots.Add(SlotIdx);
+
+        ENQUEUE_RENDER_COMMAND(NeuralNetworkCaptureCopy)([Slot, Resource](FRHICommandListImmediate& RHICmdList)
+            {
+                Slot->Readback->EnqueueCopy(RHICmdList, Resource->GetRenderTargetTexture());
+            });
+
+        return true;
+    }
+
+    return false;
+}
+
+
+bool FRenderTargetCaptureSource::HasFreeCaptureSlot() const
+{
+    for (const TSharedPtr<FSlot, ESPMode::ThreadSafe>& Slot : Slots)
+    {
+        if (Slot->State.load(std::memory_order_acquire) == ESlotState::Idle)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Polls the oldest pending copy on the render thread and hands out its pixels once they have landed.
+bool FRenderTargetCaptureSource::TryGetCapture(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight)
+{
+    if (PendingSlots.Num() == 0)
+    {
+        return false;
+    }
+
+    TSharedPtr<FSlot, ESPMode::ThreadSafe> Slot = Slots[PendingSlots[0]];
+
+    if (Slot->State.load(std::memory_order_acquire) == ESlotState::Ready)
+    {
+        Swap(OutPixels, Slot->Pixels);
+        OutWidth = Slot->Width;
+        OutHeight = Slot->Height;
+
+        Slot->State.store(ESlotState::Idle, std::memory_order_release);
+        PendingSlots.RemoveAt(0, 1, false);
+        return true;
+    }
+
+    // At most one poll per slot is queued, the render thread never waits on the GPU
+    if (!Slot->bPollQueued.exchange(true))
+    {
+        const bool bSwap = bSwapRedBlue;
+        ENQUEUE_RENDER_COMMAND(NeuralNetworkCapturePoll)([Slot, bSwap](FRHICommandListImmediate& RHICmdList)
+            {
+                TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetworkCapturePoll);
+                Slot->bPollQueued.store(false);
+
+                if (!Slot->Readback->IsReady())
+                {
+                    return;
+                }
+
+                int32 RowPitchInPixels = 0;
+                const FColor* Data = static_cast<const FColor*>(Slot->Readback->Lock(RowPitchInPixels));
+                if (Data)
+                {
+                    const int32 Width = Slot->Width;
+                    const int32 Height = Slot->Height;
+                    Slot->Pixels.SetNumUninitialized(Width * Height, false);
+
+                    for (int32 Y = 0; Y < Height; ++Y)
+                    {
+                        FMemory::Memcpy(Slot->Pixels.GetData() + Y * Width, Data + Y * RowPitchInPixels, Width * sizeof(FColor));
+                    }
+
+                    if (bSwap)
+                    {
+                        for (FColor& Pixel : Slot->Pixels)
+                        {
+                            Swap(Pixel.R, Pixel.B);
+                        }
+                    }
+                }
+                Slot->Readback->Unlock();
+
+                Slot->State.store(ESlotState::Ready, std::memory_order_release);
+            });
+    }
+
+    return false;
+}
+
+
+FSyntheticCaptureSource::FSyntheticCaptureSource(int32 InWidth, int32 InHeight)
+    : Width(FMath::Max(1, InWidth))
+    , Height(FMath::Max(1, InHeight))
+{
+}
+
+
+bool FSyntheticCaptureSource::RequestCapture()
+{
+    NumPendingCaptures++;
+    return true;
+}
+
+
+// Generates a diagonal gradient with a bright square that moves every frame.
+bool FSyntheticCaptureSource::TryGetCapture(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight)
+{
+    if (NumPendingCaptures == 0)
+    {
+        return false;
+    }
+    NumPendingCaptures--;
+
+    OutPixels.SetNumUninitialized(Width * Height, false);
+    OutWidth = Width;
+    OutHeight = Height;
+
+    const int32 SquareSize = FMath::Max(1, FMath::Min(Width, Height) / 4);
+    const int32 SquareX = (FrameIndex * 7) % FMath::Max(1, Width - SquareSize);
+    const int32 SquareY = (FrameIndex * 3) % FMath::Max(1, Height - SquareSize);
+
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; X < Width; ++X)
+        {
+            const bool bInSquare = X >= SquareX && X < SquareX + SquareSize && Y >= SquareY && Y < SquareY + SquareSize;
+            const uint8 Gradient = static_cast<uint8>(((X + Y) * 255) / FMath::Max(1, Width + Height - 2));
+            OutPixels[Y * Width + X] = bInSquare ? FColor::White : FColor(Gradient, Gradient / 2, 255 - Gradient, 255);
+        }
+    }
+
+    FrameIndex++;
+    return true;
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include <atomic>
+
+class FRHIGPUTextureReadback;
+
+// Source of captured frames for the preprocessing pipeline. All methods are called on the game thread.
+class AI_PLAYGROUND_API INeuralNetworkCaptureSource
+{
+public:
+    virtual ~INeuralNetworkCaptureSource() = default;
+
+    // Starts capturing a new frame without blocking, returns false if no capture slot is free
+    virtual bool RequestCapture() = 0;
+
+    // Hands out the oldest finished capture, false if none is ready yet. OutPixels is swapped with internal storage, so reusing it avoids allocations.
+    virtual bool TryGetCapture(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight) = 0;
+
+    // Number of captures requested but not handed out yet
+    virtual int32 GetNumPendingCaptures() const = 0;
+
+    // True if RequestCapture would find a free slot right now
+    virtual bool HasFreeCaptureSlot() const = 0;
+};
+
+// Reads a render target back through a ring of GPU staging buffers, pixels arrive a few frames after the request instead of flushing rendering
+class AI_PLAYGROUND_API FRenderTargetCaptureSource : public INeuralNetworkCaptureSource
+{
+public:
+    FRenderTargetCaptureSource(UTextureRenderTarget2D* InRenderTarget, int32 NumStagingBuffers);
+
+    virtual bool RequestCapture() override;
+    virtual bool TryGetCapture(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight) override;
+    virtual int32 GetNumPendingCaptures() const override { return PendingSlots.Num(); }
+    virtual bool HasFreeCaptureSlot() const override;
+
+private:
+    enum class ESlotState : uint8
+    {
+        Idle,
+        Copying,
+        Ready
+    };
+
+    // One staging buffer, shared with the render commands that fill it
+    struct FSlot
+    {
+        TUniquePtr<FRHIGPUTextureReadback> Readback;
+        TArray<FColor> Pixels;
+        int32 Width = 0;
+        int32 Height = 0;
+        std::atomic<ESlotState> State{ ESlotState::Idle };
+        std::atomic<bool> bPollQueued{ false };
+    };
+
+    TWeakObjectPtr<UTextureRenderTarget2D> RenderTarget;
+
+    TArray<TSharedPtr<FSlot, ESPMode::ThreadSafe>> Slots;
+
+    // Slot indices in request order, so frames are delivered in the order they were captured
+    TArray<int32> PendingSlots;
+
+    // Render target stores R and B swapped relative to FColor
+    bool bSwapRedBlue = false;
+};
+
+// CPU-only source producing a moving test pattern, used for tests and -nullrhi runs
+class AI_PLAYGROUND_API FSyntheticCaptureSource : public INeuralNetworkCaptureSource
+{
+public:
+    FSyntheticCaptureSource(int32 InWidth, int32 InHeight);
+
+    virtual bool RequestCapture() override;
+    virtual bool TryGetCapture(TArray<FColor>& OutPixels, int32& OutWidth, int32& OutHeight) override;
+    virtual int32 GetNumPendingCaptures() const override { return NumPendingCaptures; }
+    virtual bool HasFreeCaptureSlot() const override { return true; }
+
+private:
+    int32 Width;
+    int32 Height;
+    int32 NumPendingCaptures = 0;
+    uint32 FrameIndex = 0;
+};
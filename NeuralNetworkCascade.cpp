@@ -0,0 +1,190 @@
+#include "NeuralNetworkCascade.h"
+
+
+namespace
+{
+    // Splits a tensor into planes of its last two dimensions, false if the shape does not describe the values
+    bool DescribePlanes(TConstArrayView<float> Input, TConstArrayView<int32> Shape, int32& OutPlanes, int32& OutHeight, int32& OutWidth)
+    {
+        if (Shape.Num() < 2)
+        {
+            return false;
+        }
+
+        OutHeight = Shape[Shape.Num() - 2];
+        OutWidth = Shape[Shape.Num() - 1];
+        if (OutHeight <= 0 || OutWidth <= 0)
+        {
+            return false;
+        }
+
+        const int64 PlaneSize = (int64)OutHeight * OutWidth;
+        OutPlanes = static_cast<int32>(Input.Num() / PlaneSize);
+        return OutPlanes > 0 && OutPlanes * PlaneSize == Input.Num();
+    }
+
+    // Half pixel centered source taps of one axis
+    void ComputeTaps(int32 SrcSize, int32 DstSize, TArray<int32>& OutLow, TArray<int32>& OutHigh, TArray<float>& OutFrac)
+    {
+        OutLow.SetNumUninitialized(DstSize);
+        OutHigh.SetNumUninitialized(DstSize);
+        OutFrac.SetNumUninitialized(DstSize);
+
+        const float Scale = static_cast<float>(SrcSize) / DstSize;
+        for (int32 Dst = 0; Dst < DstSize; ++Dst)
+        {
+            const float Src = FMath::Clamp((Dst + 0.5f) * Scale - 0.5f, 0.0f, static_cast<float>(SrcSize - 1));
+            OutLow[Dst] = FMath::FloorToInt32(Src);
+            OutHigh[Dst] = FMath::Min(OutLow[Dst] + 1, SrcSize - 1);
+            OutFrac[Dst] = Src - OutLow[Dst];
+        }
+    }
+}
+
+
+// Copies the region row by row out of every plane.
+bool FNeuralNetworkCascadeOps::Crop(TConstArrayView<float> Input, TConstArrayView<int32> Shape, int32 X, int32 Y, int32 Width, int32 Height, TArray<float>& Output, TArray<int32>& OutShape)
+{
+    int32 Planes = 0;
+    int32 SrcHeight = 0;
+    int32 SrcWidth = 0;
+    if (!DescribePlanes(Input, Shape, Planes, SrcHeight, SrcWidth))
+    {
+        return false;
+    }
+
+    const int32 X0 = FMath::Clamp(X, 0, SrcWidth);
+    const int32 Y0 = FMath::Clamp(Y, 0, SrcHeight);
+    const int32 X1 = FMath::Clamp(X + Width, 0, SrcWidth);
+    const int32 Y1 = FMath::Clamp(Y + Height, 0, SrcHeight);
+    if (X1 <= X0 || Y1 <= Y0)
+    {
+        return false;
+    }
+
+    const int32 DstWidth = X1 - X0;
+    const int32 DstHeight = Y1 - Y0;
+    Output.SetNumUninitialized(Planes * DstHeight * DstWidth);
+
+    for (int32 Plane = 0; Plane < Planes; ++Plane)
+    {
+        const float* Src = Input.GetData() + ((int64)Plane * SrcHeight + Y0) * SrcWidth + X0;
+        float* Dst = Output.GetData() + (int64)Plane * DstHeight * DstWidth;
+        for (int32 Row = 0; Row < DstHeight; ++Row)
+        {
+            FMemory::Memcpy(Dst + Row * DstWidth, Src + Row * SrcWidth, DstWidth * sizeof(float));
+        }
+    }
+
+    OutShape = TArray<int32>(Shape.GetData(), Shape.Num());
+    OutShape[OutShape.Num() - 2] = DstHeight;
+    OutShape[OutShape.Num() - 1] = DstWidth;
+    return true;
+}
+
+
+// Taps are computed once per axis and shared by every plane.
+bool FNeuralNetworkCascadeOps::Resize(TConstArrayView<float> Input, TConstArrayView<int32> Shape, int32 Width, int32 Height, TArray<float>& Output, TArray<int32>& OutShape)
+{
+    int32 Planes = 0;
+    int32 SrcHeight = 0;
+    int32 SrcWidth = 0;
+    if (Width <= 0 || Height <= 0 || !DescribePlanes(Input, Shape, Planes, SrcHeight, SrcWidth))
+    {
+        return false;
+    }
+
+    TArray<int32> Left, Right, Top, Bottom;
+    TArray<float> FracX, FracY;
+    ComputeTaps(SrcWidth, Width, Left, Right, FracX);
+    ComputeTaps(SrcHeight, Height, Top, Bottom, FracY);
+
+    Output.SetNumUninitialized(Planes * Height * Width);
+
+    for (int32 Plane = 0; Plane < Planes; ++Plane)
+    {
+        const float* Src = Input.GetData() + (int64)Plane * SrcHeight * SrcWidth;
+        float* Dst = Output.GetData() + (int64)Plane * Height * Width;
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            const float* TopRow = Src + Top[Row] * SrcWidth;
+            const float* BottomRow = Src + Bottom[Row] * SrcWidth;
+            const float Fy = FracY[Row];
+            for (int32 Col = 0; Col < Width; ++Col)
+            {
+                const float Upper = FMath::Lerp(TopRow[Left[Col]], TopRow[Right[Col]], FracX[Col]);
+                const float Lower = FMath::Lerp(BottomRow[Left[Col]], BottomRow[Right[Col]], FracX[Col]);
+                Dst[Row * Width + Col] = FMath::Lerp(Upper, Lower, Fy);
+            }
+        }
+    }
+
+    OutShape = TArray<int32>(Shape.GetData(), Shape.Num());
+    OutShape[OutShape.Num() - 2] = Height;
+    OutShape[OutShape.Num() - 1] = Width;
+    return true;
+}
+
+
+// Folded into one multiply-add per value, planes cycle through the channels of dimension -3.
+bool FNeuralNetworkCascadeOps::Normalize(TConstArrayView<float> Input, TConstArrayView<int32> Shape, float InputScale, const FVector3f& Mean, const FVector3f& Std, TArray<float>& Output)
+{
+    int32 Channels = 1;
+    int64 PlaneSize = Input.Num();
+    if (Shape.Num() >= 3)
+    {
+        Channels = Shape[Shape.Num() - 3];
+        PlaneSize = (int64)Shape[Shape.Num() - 2] * Shape[Shape.Num() - 1];
+    }
+    if (Channels <= 0 || PlaneSize <= 0 || Input.Num() % PlaneSize != 0)
+    {
+        return false;
+    }
+
+    float Scale[3];
+    float Offset[3];
+    for (int32 Channel = 0; Channel < 3; ++Channel)
+    {
+        const int32 Component = Channels == 1 ? 0 : Channel;
+        if (FMath::IsNearlyZero(Std[Component]))
+        {
+            return false;
+        }
+        Scale[Channel] = InputScale / Std[Component];
+        Offset[Channel] = -Mean[Component] / Std[Component];
+    }
+
+    Output.SetNumUninitialized(Input.Num());
+
+    const int64 Planes = Input.Num() / PlaneSize;
+    for (int64 Plane = 0; Plane < Planes; ++Plane)
+    {
+        const int32 Channel = static_cast<int32>(Plane % Channels);
+        const float PlaneScale = Channel < 3 ? Scale[Channel] : Scale[0];
+        const float PlaneOffset = Channel < 3 ? Offset[Channel] : Offset[0];
+
+        const float* Src = Input.GetData() + Plane * PlaneSize;
+        float* Dst = Output.GetData() + Plane * PlaneSize;
+        for (int64 Idx = 0; Idx < PlaneSize; ++Idx)
+        {
+            Dst[Idx] = Src[Idx] * PlaneScale + PlaneOffset;
+        }
+    }
+
+    return true;
+}
+
+
+int32 FNeuralNetworkCascadeOps::ArgMax(TConstArrayView<float> Input)
+{
+    int32 BestIdx = INDEX_NONE;
+    for (int32 Idx = 0; Idx < Input.Num(); ++Idx)
+    {
+        if (BestIdx == INDEX_NONE || Input[Idx] > Input[BestIdx])
+        {
+            BestIdx = Idx;
+        }
+    }
+
+    return BestIdx;
+}
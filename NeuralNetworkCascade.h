@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkCascade.generated.h"
+
+class ANeuralNetwork;
+
+// What one cascade stage does with its source tensor
+UENUM(BlueprintType)
+enum class ENNECascadeOp : uint8
+{
+    // Runs Network on the tensor, its first output becomes the stage output
+    Model,
+    // Cuts the X, Y, Width, Height region out of the last two dimensions
+    Crop,
+    // Bilinear resize of the last two dimensions to Width x Height
+    Resize,
+    // Out = (Value * InputScale - Mean) / Std per channel
+    Normalize,
+    // Index of the largest value as a single value tensor
+    ArgMax
+};
+
+// One step of a cascade started with ANeuralNetwork::RunAsyncCascade
+USTRUCT(BlueprintType)
+struct AI_PLAYGROUND_API FNNECascadeStage
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    ENNECascadeOp Op = ENNECascadeOp::Model;
+
+    // Model stages only, null runs the actor the cascade is started on
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    TObjectPtr<ANeuralNetwork> Network;
+
+    // Tensor the stage reads, -1 is the previous stage's output, 0 the cascade input and N the output of stage N - 1
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference", meta = (ClampMin = "-1", UIMin = "-1"))
+    int32 Source = -1;
+
+    // Crop origin
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    int32 X = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    int32 Y = 0;
+
+    // Crop size or resize target
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    int32 Width = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    int32 Height = 0;
+
+    // Crop at the [x0, y0, x1, y1] box held in the first four values of the previous stage's output, relative to the source size
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    bool bBoxFromPrevious = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    float InputScale = 1.0f;
+
+    // Per channel mean and standard deviation, single channel tensors and channels past the third use X
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    FVector3f Mean = FVector3f::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Inference")
+    FVector3f Std = FVector3f::OneVector;
+};
+
+// Glue kernels between cascade stages. Images are [..., C, H, W] tensors, every leading plane is processed the same way.
+struct AI_PLAYGROUND_API FNeuralNetworkCascadeOps
+{
+    // The region is clamped to the image, returns false if nothing of it is left
+    static bool Crop(TConstArrayView<float> Input, TConstArrayView<int32> Shape, int32 X, int32 Y, int32 Width, int32 Height, TArray<float>& Output, TArray<int32>& OutShape);
+
+    // Bilinear with pixel centers aligned, returns false on invalid sizes
+    static bool Resize(TConstArrayView<float> Input, TConstArrayView<int32> Shape, int32 Width, int32 Height, TArray<float>& Output, TArray<int32>& OutShape);
+
+    // Channels are dimension -3 of rank 3 and higher tensors, returns false for a zero Std
+    static bool Normalize(TConstArrayView<float> Input, TConstArrayView<int32> Shape, float InputScale, const FVector3f& Mean, const FVector3f& Std, TArray<float>& Output);
+
+    // First index of the largest value, INDEX_NONE when empty
+    static int32 ArgMax(TConstArrayView<float> Input);
+};
@@ -0,0 +1,77 @@
+#include "NeuralNetworkClipBuffer.h"
+
+
+FNeuralNetworkClipBuffer::FNeuralNetworkClipBuffer(int32 InNumFrames, int32 InFrameVolume, int32 SpareFrames)
+    : NumFrames(FMath::Max(1, InNumFrames))
+    , FrameVolume(FMath::Max(1, InFrameVolume))
+    , NumSlots(NumFrames + FMath::Max(0, SpareFrames))
+{
+    Data.SetNumZeroed((NumSlots + NumFrames - 1) * FrameVolume);
+    SlotReaders.SetNumZeroed(NumSlots);
+}
+
+
+TArrayView<float> FNeuralNetworkClipBuffer::BeginFrame()
+{
+    const int32 Slot = static_cast<int32>(NumCommitted % NumSlots);
+    if (SlotReaders[Slot] > 0)
+    {
+        return TArrayView<float>();
+    }
+
+    return TArrayView<float>(Data.GetData() + Slot * FrameVolume, FrameVolume);
+}
+
+
+// Mirrored slots are copied past the end of the ring so windows that wrap stay contiguous.
+void FNeuralNetworkClipBuffer::CommitFrame()
+{
+    const int32 Slot = static_cast<int32>(NumCommitted % NumSlots);
+    if (Slot < NumFrames - 1)
+    {
+        FMemory::Memcpy(Data.GetData() + (NumSlots + Slot) * FrameVolume, Data.GetData() + Slot * FrameVolume, FrameVolume * sizeof(float));
+    }
+
+    NumCommitted++;
+}
+
+
+bool FNeuralNetworkClipBuffer::IsWindowReady() const
+{
+    return NumCommitted >= NumFrames;
+}
+
+
+// The window starts at the oldest of the newest NumFrames frames and runs through the mirror when it wraps.
+int32 FNeuralNetworkClipBuffer::AcquireWindow(TArrayView<float>& OutWindow)
+{
+    if (!IsWindowReady())
+    {
+        OutWindow = TArrayView<float>();
+        return INDEX_NONE;
+    }
+
+    const int32 FirstSlot = static_cast<int32>((NumCommitted - NumFrames) % NumSlots);
+    for (int32 FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx)
+    {
+        SlotReaders[(FirstSlot + FrameIdx) % NumSlots]++;
+    }
+
+    OutWindow = TArrayView<float>(Data.GetData() + FirstSlot * FrameVolume, NumFrames * FrameVolume);
+    return FirstSlot;
+}
+
+
+void FNeuralNetworkClipBuffer::ReleaseWindow(int32 FirstSlot)
+{
+    if (FirstSlot < 0 || FirstSlot >= NumSlots)
+    {
+        return;
+    }
+
+    for (int32 FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx)
+    {
+        int32& Readers = SlotReaders[(FirstSlot + FrameIdx) % NumSlots];
+        Readers = FMath::Max(0, Readers - 1);
+    }
+}
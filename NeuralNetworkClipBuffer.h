@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Ring of preprocessed frames for rank 5 [1, Frame, C, H, W] inputs.
+ * The first NumFrames - 1 ring slots are mirrored past the end of the ring, so the newest NumFrames frames are always
+ * contiguous and can be bound as the model input without assembling the clip. Each pushed frame costs one frame of
+ * preprocessing plus, for mirrored slots, one frame copy. Only accessed on the game thread.
+ */
+class AI_PLAYGROUND_API FNeuralNetworkClipBuffer
+{
+public:
+    // SpareFrames extra ring slots let new frames be written while that many older windows are still being inferred
+    FNeuralNetworkClipBuffer(int32 InNumFrames, int32 InFrameVolume, int32 SpareFrames);
+
+    // Writable view of the next frame slot, empty while an in-flight inference still reads that slot
+    TArrayView<float> BeginFrame();
+
+    // Publishes the frame written through BeginFrame
+    void CommitFrame();
+
+    // True once NumFrames frames have been committed
+    bool IsWindowReady() const;
+
+    // Pins the slots of the newest window until ReleaseWindow and returns its first ring slot, INDEX_NONE if not ready
+    int32 AcquireWindow(TArrayView<float>& OutWindow);
+
+    void ReleaseWindow(int32 FirstSlot);
+
+    int32 GetNumFrames() const { return NumFrames; }
+    int32 GetFrameVolume() const { return FrameVolume; }
+
+private:
+    int32 NumFrames;
+    int32 FrameVolume;
+    int32 NumSlots;
+    int64 NumCommitted = 0;
+
+    // NumSlots ring slots followed by the NumFrames - 1 mirrored ones
+    TArray<float, TAlignedHeapAllocator<64>> Data;
+
+    // In-flight windows reading each ring slot
+    TArray<int32> SlotReaders;
+};
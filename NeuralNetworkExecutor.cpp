@@ -0,0 +1,108 @@
+#include "NeuralNetworkExecutor.h"
+#include "NeuralNetworkStats.h"
+
+
+namespace
+{
+    thread_local bool bIsExecutorThread = false;
+    thread_local uint64 AppliedAffinityMask = 0;
+}
+
+
+// One queued job, deleted by the pool thread once it ran or was abandoned.
+class FNeuralNetworkExecutor::FJob : public IQueuedWork
+{
+public:
+    FJob(FNeuralNetworkExecutor& InExecutor, TUniqueFunction<void()>&& InJob)
+        : Executor(InExecutor)
+        , Job(MoveTemp(InJob))
+    {
+    }
+
+    virtual void DoThreadedWork() override
+    {
+        Executor.NumQueued--;
+        SET_DWORD_STAT(STAT_NeuralNetwork_ExecutorQueueDepth, Executor.NumQueued.load(std::memory_order_relaxed));
+
+        // Pool threads only ever run executor jobs, the mask is applied on their first job
+        bIsExecutorThread = true;
+        if (Executor.AffinityMask != 0 && AppliedAffinityMask != Executor.AffinityMask)
+        {
+            FPlatformProcess::SetThreadAffinityMask(Executor.AffinityMask);
+            AppliedAffinityMask = Executor.AffinityMask;
+        }
+
+        const uint64 Started = FPlatformTime::Cycles64();
+        Job();
+        Executor.BusyCycles += FPlatformTime::Cycles64() - Started;
+
+        delete this;
+    }
+
+    virtual void Abandon() override
+    {
+        Executor.NumQueued--;
+        delete this;
+    }
+
+    virtual const TCHAR* GetDebugName() const override
+    {
+        return TEXT("NeuralNetworkJob");
+    }
+
+private:
+    FNeuralNetworkExecutor& Executor;
+    TUniqueFunction<void()> Job;
+};
+
+
+FNeuralNetworkExecutor::FNeuralNetworkExecutor(int32 InNumWorkers, EThreadPriority Priority, uint64 InAffinityMask)
+    : NumWorkers(FMath::Max(1, InNumWorkers))
+    , AffinityMask(InAffinityMask)
+{
+    Pool = FQueuedThreadPool::Allocate();
+    Pool->Create(NumWorkers, 128 * 1024, Priority, TEXT("NeuralNetworkExecutor"));
+
+    LastSampleCycles = FPlatformTime::Cycles64();
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("Created inference executor with %d workers"), NumWorkers);
+}
+
+
+FNeuralNetworkExecutor::~FNeuralNetworkExecutor()
+{
+    // Abandons what is still queued and waits for the running jobs, so no job outlives the counters
+    Pool->Destroy();
+    delete Pool;
+}
+
+
+void FNeuralNetworkExecutor::Execute(TUniqueFunction<void()> Job)
+{
+    NumQueued++;
+    SET_DWORD_STAT(STAT_NeuralNetwork_ExecutorQueueDepth, NumQueued.load(std::memory_order_relaxed));
+
+    Pool->AddQueuedWork(new FJob(*this, MoveTemp(Job)));
+}
+
+
+float FNeuralNetworkExecutor::SampleUtilization()
+{
+    const uint64 Now = FPlatformTime::Cycles64();
+    const uint64 Busy = BusyCycles.load(std::memory_order_relaxed);
+
+    const uint64 Elapsed = Now - LastSampleCycles;
+    const float Utilization = Elapsed > 0 ? FMath::Clamp(static_cast<float>(Busy - LastBusyCycles) / (static_cast<float>(Elapsed) * NumWorkers), 0.0f, 1.0f) : 0.0f;
+
+    LastSampleCycles = Now;
+    LastBusyCycles = Busy;
+
+    SET_FLOAT_STAT(STAT_NeuralNetwork_ExecutorUtilization, Utilization * 100.0f);
+    return Utilization;
+}
+
+
+bool FNeuralNetworkExecutor::IsExecutorThread()
+{
+    return bIsExecutorThread;
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/QueuedThreadPool.h"
+#include <atomic>
+
+/**
+ * Dedicated worker threads for inference and preprocessing jobs, so long RunSync calls do not occupy the engine's
+ * task graph workers that physics and animation depend on. The worker count caps the cores inference can use.
+ * Queued jobs are abandoned when the executor is destroyed, running jobs are waited for.
+ */
+class AI_PLAYGROUND_API FNeuralNetworkExecutor
+{
+public:
+    // An AffinityMask of 0 leaves the workers on any core
+    FNeuralNetworkExecutor(int32 InNumWorkers, EThreadPriority Priority, uint64 InAffinityMask);
+    ~FNeuralNetworkExecutor();
+
+    // Queues a job for the next free worker, callable from any thread
+    void Execute(TUniqueFunction<void()> Job);
+
+    int32 GetNumWorkers() const { return NumWorkers; }
+
+    // Jobs waiting for a worker
+    int32 GetQueueDepth() const { return NumQueued.load(std::memory_order_relaxed); }
+
+    // Fraction of worker time spent in jobs since the previous call, game thread only
+    float SampleUtilization();
+
+    // True on executor workers, nested parallel work runs inline there instead of spilling onto the task graph
+    static bool IsExecutorThread();
+
+private:
+    class FJob;
+
+    FQueuedThreadPool* Pool = nullptr;
+    int32 NumWorkers = 0;
+    uint64 AffinityMask = 0;
+
+    std::atomic<int32> NumQueued{ 0 };
+    std::atomic<uint64> BusyCycles{ 0 };
+
+    uint64 LastSampleCycles = 0;
+    uint64 LastBusyCycles = 0;
+};
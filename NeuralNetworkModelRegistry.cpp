@@ -0,0 +1,66 @@
+#include "NeuralNetworkModelRegistry.h"
+#include "NeuralNetworkStats.h"
+
+
+// Looks the model up under the lock and creates it there on a miss.
+FSharedModelCPU UNeuralNetworkModelRegistry::FindOrCreateModel(INNERuntimeCPU& Runtime, const FString& RuntimeName, UNNEModelData* ModelData)
+{
+    if (!ModelData)
+    {
+        return nullptr;
+    }
+
+    FScopeLock Lock(&m_mutex);
+
+    const FModelKey Key{ ModelData, RuntimeName };
+    if (const TWeakPtr<UE::NNE::IModelCPU, ESPMode::ThreadSafe>* Existing = m_Models.Find(Key))
+    {
+        if (FSharedModelCPU Model = Existing->Pin())
+        {
+            return Model;
+        }
+    }
+
+    PruneExpiredModels();
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_CreateSharedModel);
+
+    FSharedModelCPU Model(Runtime.CreateModel(ModelData).Release());
+    if (Model.IsValid())
+    {
+        m_Models.Add(Key, Model);
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Created shared model %s, %d models in the registry"), *ModelData->GetName(), m_Models.Num());
+    }
+
+    return Model;
+}
+
+
+int32 UNeuralNetworkModelRegistry::GetNumSharedModels()
+{
+    FScopeLock Lock(&m_mutex);
+    PruneExpiredModels();
+    return m_Models.Num();
+}
+
+
+void UNeuralNetworkModelRegistry::Deinitialize()
+{
+    // Actors still holding a model keep it alive, the registry only forgets it
+    FScopeLock Lock(&m_mutex);
+    m_Models.Reset();
+
+    Super::Deinitialize();
+}
+
+
+void UNeuralNetworkModelRegistry::PruneExpiredModels()
+{
+    for (auto It = m_Models.CreateIterator(); It; ++It)
+    {
+        if (!It.Value().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "NNERuntimeCPU.h"
+#include "NNEModelData.h"
+
+#include "NeuralNetworkModelRegistry.generated.h"
+
+using FSharedModelCPU = TSharedPtr<UE::NNE::IModelCPU, ESPMode::ThreadSafe>;
+
+/**
+ * Process-wide cache of created CPU models, one per model asset and runtime.
+ * Actors share the model and only create their own instances from it. An entry lives as long as someone
+ * holds its shared pointer, so memory scales with the number of distinct models in use.
+ */
+UCLASS()
+class AI_PLAYGROUND_API UNeuralNetworkModelRegistry : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Returns the shared model for the asset, creating it on first use. Safe to call from any thread.
+    FSharedModelCPU FindOrCreateModel(INNERuntimeCPU& Runtime, const FString& RuntimeName, UNNEModelData* ModelData);
+
+    // Number of models currently alive in the registry
+    UFUNCTION(BlueprintCallable, Category = "NNE Neural Network")
+    int32 GetNumSharedModels();
+
+    virtual void Deinitialize() override;
+
+private:
+    struct FModelKey
+    {
+        TObjectKey<UNNEModelData> ModelData;
+        FString RuntimeName;
+
+        bool operator==(const FModelKey& Other) const
+        {
+            return ModelData == Other.ModelData && RuntimeName == Other.RuntimeName;
+        }
+
+        friend uint32 GetTypeHash(const FModelKey& Key)
+        {
+            return HashCombine(GetTypeHash(Key.ModelData), GetTypeHash(Key.RuntimeName));
+        }
+    };
+
+    // Drops entries whose model has been released by every user. Must be called with m_mutex held.
+    void PruneExpiredModels();
+
+    // Held while creating, so two actors asking for the same asset at once still create it once
+    FCriticalSection m_mutex;
+
+    TMap<FModelKey, TWeakPtr<UE::NNE::IModelCPU, ESPMode::ThreadSafe>> m_Models;
+};
@@ -0,0 +1,201 @@
+#include "NeuralNetworkPostProcessing.h"
+#include "NeuralNetworkStats.h"
+#include "NeuralNetworkExecutor.h"
+#include "Async/ParallelFor.h"
+
+
+namespace
+{
+    // Locations handled per ParallelFor task in per location mode
+    constexpr int32 LocationChunkSize = 1024;
+
+    // Argmax over the class dimension of an [N, C, ...] tensor, walking each class plane contiguously
+    void ReduceLocations(TConstArrayView<float> Output, int32 Batch, int32 NumClasses, int32 NumSpatial, const FNNEPostProcessSettings& Settings, FNNEClassificationResult& OutResult)
+    {
+        OutResult.LabelMap.SetNumUninitialized(Batch * NumSpatial);
+        OutResult.LabelScores.SetNumUninitialized(Batch * NumSpatial);
+
+        const int32 ChunksPerBatch = FMath::DivideAndRoundUp(NumSpatial, LocationChunkSize);
+        // Inline on executor workers, an inference job must not spill onto the task graph workers
+        const EParallelForFlags Flags = FNeuralNetworkExecutor::IsExecutorThread() ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+        ParallelFor(Batch * ChunksPerBatch, [&](int32 ChunkIdx)
+            {
+                const int32 BatchIdx = ChunkIdx / ChunksPerBatch;
+                const int32 SpatialStart = (ChunkIdx % ChunksPerBatch) * LocationChunkSize;
+                const int32 Count = FMath::Min(LocationChunkSize, NumSpatial - SpatialStart);
+
+                const float* Planes = Output.GetData() + (int64)BatchIdx * NumClasses * NumSpatial + SpatialStart;
+                int32* Labels = OutResult.LabelMap.GetData() + BatchIdx * NumSpatial + SpatialStart;
+                float* Best = OutResult.LabelScores.GetData() + BatchIdx * NumSpatial + SpatialStart;
+
+                for (int32 Idx = 0; Idx < Count; ++Idx)
+                {
+                    Labels[Idx] = 0;
+                    Best[Idx] = Planes[Idx];
+                }
+                for (int32 ClassIdx = 1; ClassIdx < NumClasses; ++ClassIdx)
+                {
+                    const float* Plane = Planes + (int64)ClassIdx * NumSpatial;
+                    for (int32 Idx = 0; Idx < Count; ++Idx)
+                    {
+                        if (Plane[Idx] > Best[Idx])
+                        {
+                            Best[Idx] = Plane[Idx];
+                            Labels[Idx] = ClassIdx;
+                        }
+                    }
+                }
+
+                if (Settings.bSoftmax)
+                {
+                    // The best class has probability 1 / sum(exp(x - best))
+                    float SumExp[LocationChunkSize];
+                    FMemory::Memzero(SumExp, Count * sizeof(float));
+                    for (int32 ClassIdx = 0; ClassIdx < NumClasses; ++ClassIdx)
+                    {
+                        const float* Plane = Planes + (int64)ClassIdx * NumSpatial;
+                        for (int32 Idx = 0; Idx < Count; ++Idx)
+                        {
+                            SumExp[Idx] += FMath::Exp(Plane[Idx] - Best[Idx]);
+                        }
+                    }
+                    for (int32 Idx = 0; Idx < Count; ++Idx)
+                    {
+                        Best[Idx] = 1.0f / SumExp[Idx];
+                    }
+                }
+
+                for (int32 Idx = 0; Idx < Count; ++Idx)
+                {
+                    if (Best[Idx] < Settings.ScoreThreshold)
+                    {
+                        Labels[Idx] = INDEX_NONE;
+                    }
+                }
+            }, Flags);
+    }
+}
+
+
+// Keeps a small sorted list for a bounded K, sorts the survivors when K is unbounded.
+void FNeuralNetworkPostProcessing::TopK(TConstArrayView<float> Values, int32 K, float MinValue, TArray<int32>& OutIndices, TArray<float>& OutValues)
+{
+    OutIndices.Reset();
+    OutValues.Reset();
+
+    if (K <= 0)
+    {
+        for (int32 Idx = 0; Idx < Values.Num(); ++Idx)
+        {
+            if (Values[Idx] >= MinValue)
+            {
+                OutIndices.Add(Idx);
+            }
+        }
+        OutIndices.Sort([&Values](int32 A, int32 B)
+            {
+                return Values[A] > Values[B];
+            });
+    }
+    else
+    {
+        OutIndices.Reserve(K + 1);
+        for (int32 Idx = 0; Idx < Values.Num(); ++Idx)
+        {
+            const float Value = Values[Idx];
+            if (Value < MinValue || (OutIndices.Num() == K && Value <= Values[OutIndices.Last()]))
+            {
+                continue;
+            }
+
+            int32 InsertAt = OutIndices.Num();
+            while (InsertAt > 0 && Values[OutIndices[InsertAt - 1]] < Value)
+            {
+                --InsertAt;
+            }
+            OutIndices.Insert(Idx, InsertAt);
+            if (OutIndices.Num() > K)
+            {
+                OutIndices.Pop(false);
+            }
+        }
+    }
+
+    OutValues.Reserve(OutIndices.Num());
+    for (int32 Idx : OutIndices)
+    {
+        OutValues.Add(Values[Idx]);
+    }
+}
+
+
+// Ranks classes over a single item tensor, or labels every location of an [N, C, ...] tensor.
+bool FNeuralNetworkPostProcessing::Process(TConstArrayView<float> Output, TConstArrayView<uint32> ShapeData, const FNNEPostProcessSettings& Settings, FNNEClassificationResult& OutResult)
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_PostProcess);
+
+    OutResult = FNNEClassificationResult();
+
+    if (Output.Num() == 0)
+    {
+        return false;
+    }
+
+    if (Settings.bPerLocation)
+    {
+        if (ShapeData.Num() < 2 || ShapeData[1] == 0)
+        {
+            return false;
+        }
+
+        const int32 Batch = ShapeData[0];
+        const int32 NumClasses = ShapeData[1];
+        const int32 NumSpatial = Output.Num() / FMath::Max(1, Batch * NumClasses);
+        if ((int64)Batch * NumClasses * NumSpatial != Output.Num())
+        {
+            return false;
+        }
+
+        OutResult.NumClasses = NumClasses;
+        ReduceLocations(Output, Batch, NumClasses, NumSpatial, Settings, OutResult);
+        return true;
+    }
+
+    // One ranking per call, rows of a batched [N, C] output would otherwise compete in a single distribution
+    if (ShapeData.Num() >= 2 && ShapeData[0] > 1)
+    {
+        return false;
+    }
+
+    OutResult.NumClasses = Output.Num();
+
+    if (!Settings.bSoftmax)
+    {
+        TopK(Output, Settings.TopK, Settings.ScoreThreshold, OutResult.ClassIndices, OutResult.Scores);
+        return true;
+    }
+
+    // Softmax is monotonic, so rank the logits and only convert the survivors to probabilities
+    float MaxLogit = Output[0];
+    for (float Value : Output)
+    {
+        MaxLogit = FMath::Max(MaxLogit, Value);
+    }
+
+    float SumExp = 0.0f;
+    for (float Value : Output)
+    {
+        SumExp += FMath::Exp(Value - MaxLogit);
+    }
+
+    const float MinLogit = Settings.ScoreThreshold > 0.0f ? MaxLogit + FMath::Loge(Settings.ScoreThreshold * SumExp) : -MAX_flt;
+    TopK(Output, Settings.TopK, MinLogit, OutResult.ClassIndices, OutResult.Scores);
+
+    for (float& Score : OutResult.Scores)
+    {
+        Score = FMath::Exp(Score - MaxLogit) / SumExp;
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPostProcessing.generated.h"
+
+// Reductions run on the worker thread so only the compact result reaches the game thread
+USTRUCT(BlueprintType)
+struct AI_PLAYGROUND_API FNNEPostProcessSettings
+{
+    GENERATED_BODY()
+
+    // Turn raw logits into probabilities over the classes before ranking and thresholding
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PostProcessing")
+    bool bSoftmax = true;
+
+    // Number of best classes to return, 1 is a plain argmax, 0 returns every class above ScoreThreshold
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PostProcessing", meta = (ClampMin = "0", UIMin = "0"))
+    int32 TopK = 1;
+
+    // Classes scoring below this are dropped, per location results below it are labeled -1
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PostProcessing")
+    float ScoreThreshold = 0.0f;
+
+    // Reduce over dimension 1 of an [N, C, ...] output at every location instead of over the whole tensor, e.g. for segmentation maps
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PostProcessing")
+    bool bPerLocation = false;
+};
+
+// Compact output of the post-processing stage
+USTRUCT(BlueprintType)
+struct AI_PLAYGROUND_API FNNEClassificationResult
+{
+    GENERATED_BODY()
+
+    // Best classes first, at most TopK entries
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Data PostProcessing")
+    TArray<int32> ClassIndices;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Data PostProcessing")
+    TArray<float> Scores;
+
+    // Best class at every location in [N, ...] order, only filled in per location mode
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Data PostProcessing")
+    TArray<int32> LabelMap;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Data PostProcessing")
+    TArray<float> LabelScores;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE Data PostProcessing")
+    int32 NumClasses = 0;
+};
+
+// Output reductions that turn raw model outputs into class results
+struct AI_PLAYGROUND_API FNeuralNetworkPostProcessing
+{
+    // Runs the configured reductions over one output tensor. Returns false when the shape does not fit the settings,
+    // outside per location mode that includes a leading batch dimension greater than one.
+    static bool Process(TConstArrayView<float> Output, TConstArrayView<uint32> ShapeData, const FNNEPostProcessSettings& Settings, FNNEClassificationResult& OutResult);
+
+    // Best K entries of Values, highest first, K of 0 keeps every entry not below MinValue
+    static void TopK(TConstArrayView<float> Values, int32 K, float MinValue, TArray<int32>& OutIndices, TArray<float>& OutValues);
+};
@@ -0,0 +1,403 @@
+#include "NeuralNetworkPreProcessing.h"
+#include "NeuralNetworkStats.h"
+#include "NeuralNetworkExecutor.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+
+namespace
+{
+    // Pixels handled per ParallelFor task when normalizing flat buffers
+    constexpr int32 NormalizeChunkSize = 4096;
+
+    // Maps 8-bit channel values to [0,1] without the sRGB curve
+    struct FByteToUnitTable
+    {
+        float Values[256];
+
+        FByteToUnitTable()
+        {
+            for (int32 Idx = 0; Idx < 256; ++Idx)
+            {
+                Values[Idx] = Idx / 255.0f;
+            }
+        }
+    };
+
+    const float* GetByteToUnitTable(bool bSRGBToLinear)
+    {
+        static const FByteToUnitTable LinearTable;
+        return bSRGBToLinear ? FLinearColor::sRGBToLinearTable : LinearTable.Values;
+    }
+
+    // Looks up a filtered channel value in [0,255] between two table entries
+    FORCEINLINE float ByteToUnit(const float* Table, float Value)
+    {
+        const float Clamped = FMath::Clamp(Value, 0.0f, 255.0f);
+        const int32 Idx = FMath::Min(static_cast<int32>(Clamped), 254);
+        return FMath::Lerp(Table[Idx], Table[Idx + 1], Clamped - Idx);
+    }
+
+    // Source taps and weights of every output coordinate along one axis, MaxTaps entries per output with unused weights zeroed
+    struct FResizeAxisTaps
+    {
+        TArray<int32> First;
+        TArray<float> Weights;
+        int32 MaxTaps = 0;
+    };
+
+    TSharedRef<const FResizeAxisTaps> BuildResizeAxisTaps(int32 SrcSize, int32 DstSize, ENNEResizeFilter Filter)
+    {
+        TSharedRef<FResizeAxisTaps> Taps = MakeShared<FResizeAxisTaps>();
+        const float Scale = static_cast<float>(SrcSize) / DstSize;
+
+        // Area only differs from bilinear when shrinking
+        if (Filter == ENNEResizeFilter::Area && Scale > 1.0f)
+        {
+            Taps->MaxTaps = FMath::CeilToInt32(Scale) + 1;
+            Taps->First.SetNumUninitialized(DstSize);
+            Taps->Weights.SetNumZeroed(DstSize * Taps->MaxTaps);
+
+            for (int32 Dst = 0; Dst < DstSize; ++Dst)
+            {
+                const float Start = Dst * Scale;
+                const float End = FMath::Min((Dst + 1) * Scale, static_cast<float>(SrcSize));
+                const int32 First = FMath::FloorToInt32(Start);
+                const int32 Last = FMath::Min(FMath::CeilToInt32(End), SrcSize) - 1;
+
+                Taps->First[Dst] = First;
+                for (int32 Src = First; Src <= Last && Src - First < Taps->MaxTaps; ++Src)
+                {
+                    const float Coverage = FMath::Min(End, Src + 1.0f) - FMath::Max(Start, static_cast<float>(Src));
+                    Taps->Weights[Dst * Taps->MaxTaps + Src - First] = FMath::Max(Coverage, 0.0f) / Scale;
+                }
+            }
+        }
+        else
+        {
+            Taps->MaxTaps = 2;
+            Taps->First.SetNumUninitialized(DstSize);
+            Taps->Weights.SetNumZeroed(DstSize * 2);
+
+            for (int32 Dst = 0; Dst < DstSize; ++Dst)
+            {
+                const float Src = FMath::Clamp((Dst + 0.5f) * Scale - 0.5f, 0.0f, SrcSize - 1.0f);
+                const int32 First = FMath::Min(FMath::FloorToInt32(Src), FMath::Max(SrcSize - 2, 0));
+                const float Frac = FMath::Min(Src - First, 1.0f);
+
+                Taps->First[Dst] = First;
+                Taps->Weights[Dst * 2] = 1.0f - Frac;
+                Taps->Weights[Dst * 2 + 1] = SrcSize > 1 ? Frac : 0.0f;
+            }
+        }
+
+        return Taps;
+    }
+
+    // Tap tables are cached per (source size, target size, filter) so repeated captures skip rebuilding them
+    TSharedRef<const FResizeAxisTaps> GetResizeAxisTaps(int32 SrcSize, int32 DstSize, ENNEResizeFilter Filter)
+    {
+        constexpr int32 MaxCachedAxes = 64;
+
+        static FCriticalSection CacheMutex;
+        static TMap<TTuple<int32, int32, ENNEResizeFilter>, TSharedRef<const FResizeAxisTaps>> Cache;
+
+        const TTuple<int32, int32, ENNEResizeFilter> Key(SrcSize, DstSize, Filter);
+
+        FScopeLock Lock(&CacheMutex);
+        if (const TSharedRef<const FResizeAxisTaps>* Cached = Cache.Find(Key))
+        {
+            return *Cached;
+        }
+
+        if (Cache.Num() >= MaxCachedAxes)
+        {
+            Cache.Reset();
+        }
+
+        return Cache.Add(Key, BuildResizeAxisTaps(SrcSize, DstSize, Filter));
+    }
+
+    // Separable resize straight from FColor bytes. Output rows are split across tasks, each with its own scratch row,
+    // and Sink receives every output pixel as unit R, G, B, A lanes together with its index in the target image.
+    template <typename SinkType>
+    void ResizeRows(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, bool bSRGBToLinear, const SinkType& Sink)
+    {
+        static_assert(PLATFORM_LITTLE_ENDIAN, "ResizeRows expects FColor to be stored as B, G, R, A");
+
+        const TSharedRef<const FResizeAxisTaps> TapsX = GetResizeAxisTaps(SrcWidth, DstWidth, Filter);
+        const TSharedRef<const FResizeAxisTaps> TapsY = GetResizeAxisTaps(SrcHeight, DstHeight, Filter);
+        const float* Table = GetByteToUnitTable(bSRGBToLinear);
+        const float AlphaScale = 1.0f / 255.0f;
+
+        const int32 RowFloats = SrcWidth * 4;
+        const int32 NumTasks = FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, 1, DstHeight);
+        const int32 RowsPerTask = FMath::DivideAndRoundUp(DstHeight, NumTasks);
+        // Executor workers stay inline so preprocessing jobs keep to the executor's cores
+        const bool bSmall = DstWidth * DstHeight * TapsY->MaxTaps < 16384;
+        const EParallelForFlags Flags = bSmall || FNeuralNetworkExecutor::IsExecutorThread() ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+        ParallelFor(NumTasks, [&](int32 TaskIdx)
+            {
+                TArray<float> Accumulator;
+                Accumulator.SetNumUninitialized(RowFloats);
+
+                const int32 RowStart = TaskIdx * RowsPerTask;
+                const int32 RowEnd = FMath::Min(RowStart + RowsPerTask, DstHeight);
+
+                for (int32 Y = RowStart; Y < RowEnd; ++Y)
+                {
+                    // Vertical pass over the raw bytes, a flat loop the compiler vectorizes
+                    float* Acc = Accumulator.GetData();
+                    FMemory::Memzero(Acc, RowFloats * sizeof(float));
+
+                    for (int32 Tap = 0; Tap < TapsY->MaxTaps; ++Tap)
+                    {
+                        const float Weight = TapsY->Weights[Y * TapsY->MaxTaps + Tap];
+                        if (Weight == 0.0f)
+                        {
+                            continue;
+                        }
+
+                        const uint8* SrcRow = reinterpret_cast<const uint8*>(Pixels.GetData() + (TapsY->First[Y] + Tap) * SrcWidth);
+                        for (int32 Idx = 0; Idx < RowFloats; ++Idx)
+                        {
+                            Acc[Idx] += Weight * SrcRow[Idx];
+                        }
+                    }
+
+                    // Horizontal pass, one vector per pixel holding all four channels
+                    for (int32 X = 0; X < DstWidth; ++X)
+                    {
+                        const float* Weights = TapsX->Weights.GetData() + X * TapsX->MaxTaps;
+                        const float* Column = Acc + TapsX->First[X] * 4;
+
+                        VectorRegister4Float Sum = VectorZeroFloat();
+                        for (int32 Tap = 0; Tap < TapsX->MaxTaps; ++Tap)
+                        {
+                            Sum = VectorMultiplyAdd(VectorLoad(Column + FMath::Min(Tap, SrcWidth - 1 - TapsX->First[X]) * 4), VectorSetFloat1(Weights[Tap]), Sum);
+                        }
+
+                        alignas(16) float BGRA[4];
+                        VectorStoreAligned(Sum, BGRA);
+
+                        Sink(MakeVectorRegisterFloat(ByteToUnit(Table, BGRA[2]), ByteToUnit(Table, BGRA[1]), ByteToUnit(Table, BGRA[0]), BGRA[3] * AlphaScale), Y * DstWidth + X);
+                    }
+                }
+            }, Flags);
+    }
+
+    // Stores a normalized value in the element type of the tensor, byte tensors are rounded and clamped
+    FORCEINLINE void StoreElement(float* Out, float Value)
+    {
+        *Out = Value;
+    }
+
+    FORCEINLINE void StoreElement(FFloat16* Out, float Value)
+    {
+        *Out = FFloat16(Value);
+    }
+
+    FORCEINLINE void StoreElement(uint8* Out, float Value)
+    {
+        *Out = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(Value), 0, 255));
+    }
+
+    // Normalization folded into one multiply-add per channel, plus the output addressing for one tensor
+    struct FNormalizationKernel
+    {
+        VectorRegister4Float Mul;
+        VectorRegister4Float Add;
+        VectorRegister4Float GrayWeights;
+        int32 ColorChannels;
+        int32 PlaneSize;
+        bool bNHWC;
+        bool bBGR;
+
+        FNormalizationKernel(const FNNEImageNormalization& Normalization, int32 InPlaneSize)
+            : ColorChannels(Normalization.ColorChannels)
+            , PlaneSize(InPlaneSize)
+            , bNHWC(Normalization.Layout == ENNETensorLayout::NHWC)
+            , bBGR(Normalization.ChannelOrder == ENNEChannelOrder::BGR)
+        {
+            const FVector3f& Mean = Normalization.Mean;
+            const FVector3f& Std = Normalization.Std;
+            const float Scale = Normalization.InputScale;
+
+            Mul = MakeVectorRegisterFloat(Scale / Std.X, Scale / Std.Y, Scale / Std.Z, 0.0f);
+            Add = MakeVectorRegisterFloat(-Mean.X / Std.X, -Mean.Y / Std.Y, -Mean.Z / Std.Z, 0.0f);
+            GrayWeights = MakeVectorRegisterFloat(Normalization.GrayscaleWeights.X, Normalization.GrayscaleWeights.Y, Normalization.GrayscaleWeights.Z, 0.0f);
+        }
+
+        static bool IsValid(const FNNEImageNormalization& Normalization)
+        {
+            return (Normalization.ColorChannels == 1 || Normalization.ColorChannels == 3)
+                && Normalization.Std.X != 0.0f && Normalization.Std.Y != 0.0f && Normalization.Std.Z != 0.0f;
+        }
+
+        // Writes one pixel whose linear R, G, B are in lanes 0-2
+        template <typename ElementType>
+        FORCEINLINE void Write(const VectorRegister4Float& Color, ElementType* Tensor, int32 PixelIdx) const
+        {
+            alignas(16) float Channels[4];
+
+            if (ColorChannels == 1)
+            {
+                VectorStoreAligned(VectorMultiplyAdd(VectorDot3(Color, GrayWeights), Mul, Add), Channels);
+                StoreElement(Tensor + PixelIdx, Channels[0]);
+                return;
+            }
+
+            VectorRegister4Float Normalized = VectorMultiplyAdd(Color, Mul, Add);
+            if (bBGR)
+            {
+                Normalized = VectorSwizzle(Normalized, 2, 1, 0, 3);
+            }
+            VectorStoreAligned(Normalized, Channels);
+
+            if (bNHWC)
+            {
+                ElementType* Out = Tensor + PixelIdx * 3;
+                StoreElement(Out, Channels[0]);
+                StoreElement(Out + 1, Channels[1]);
+                StoreElement(Out + 2, Channels[2]);
+            }
+            else
+            {
+                StoreElement(Tensor + PixelIdx, Channels[0]);
+                StoreElement(Tensor + PlaneSize + PixelIdx, Channels[1]);
+                StoreElement(Tensor + 2 * PlaneSize + PixelIdx, Channels[2]);
+            }
+        }
+    };
+
+    template <typename ElementType>
+    bool PixelsToTypedTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<ElementType> OutTensor)
+    {
+        NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_PreProcess);
+
+        if (SrcWidth <= 0 || SrcHeight <= 0 || DstWidth <= 0 || DstHeight <= 0 || !FNormalizationKernel::IsValid(Normalization))
+        {
+            return false;
+        }
+        if (Pixels.Num() < SrcWidth * SrcHeight || OutTensor.Num() < DstWidth * DstHeight * Normalization.ColorChannels)
+        {
+            return false;
+        }
+
+        const FNormalizationKernel Kernel(Normalization, DstWidth * DstHeight);
+        ElementType* Tensor = OutTensor.GetData();
+
+        ResizeRows(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization.bSRGBToLinear, [&Kernel, Tensor](const VectorRegister4Float& Color, int32 PixelIdx)
+            {
+                Kernel.Write(Color, Tensor, PixelIdx);
+            });
+
+        return true;
+    }
+}
+
+
+// Reads the image layout from a rank 4 input shape.
+bool FNeuralNetworkPreProcessing::DescribeImageShape(TConstArrayView<uint32> ShapeData, ENNETensorLayout& OutLayout, int32& OutColorChannels, int32& OutHeight, int32& OutWidth)
+{
+    if (ShapeData.Num() != 4)
+    {
+        return false;
+    }
+
+    const bool bChannelsFirst = ShapeData[1] == 1 || ShapeData[1] == 3;
+    const bool bChannelsLast = ShapeData[3] == 1 || ShapeData[3] == 3;
+
+    if (!bChannelsFirst && bChannelsLast)
+    {
+        OutLayout = ENNETensorLayout::NHWC;
+        OutHeight = ShapeData[1];
+        OutWidth = ShapeData[2];
+        OutColorChannels = ShapeData[3];
+    }
+    else
+    {
+        OutLayout = ENNETensorLayout::NCHW;
+        OutColorChannels = ShapeData[1];
+        OutHeight = ShapeData[2];
+        OutWidth = ShapeData[3];
+    }
+
+    return bChannelsFirst || bChannelsLast;
+}
+
+
+// Fused resize, color conversion and normalization from an FColor buffer to a float tensor.
+bool FNeuralNetworkPreProcessing::PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<float> OutTensor)
+{
+    return PixelsToTypedTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, OutTensor);
+}
+
+
+// Same pass with half precision stores, for models whose input is fp16.
+bool FNeuralNetworkPreProcessing::PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<FFloat16> OutTensor)
+{
+    return PixelsToTypedTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, OutTensor);
+}
+
+
+// Same pass with byte stores, for quantized models that take raw pixel values.
+bool FNeuralNetworkPreProcessing::PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<uint8> OutTensor)
+{
+    return PixelsToTypedTensor(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, Normalization, OutTensor);
+}
+
+
+// Resizes an FColor image into linear colors without widening the source first.
+bool FNeuralNetworkPreProcessing::ResizePixels(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, bool bSRGBToLinear, TArrayView<FLinearColor> OutPixels)
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Resize);
+
+    if (SrcWidth <= 0 || SrcHeight <= 0 || DstWidth <= 0 || DstHeight <= 0)
+    {
+        return false;
+    }
+    if (Pixels.Num() < SrcWidth * SrcHeight || OutPixels.Num() < DstWidth * DstHeight)
+    {
+        return false;
+    }
+
+    FLinearColor* Out = OutPixels.GetData();
+
+    ResizeRows(Pixels, SrcWidth, SrcHeight, DstWidth, DstHeight, Filter, bSRGBToLinear, [Out](const VectorRegister4Float& Color, int32 PixelIdx)
+        {
+            VectorStore(Color, &Out[PixelIdx].R);
+        });
+
+    return true;
+}
+
+
+// Normalizes linear colors into the tensor, each chunk of pixels is written by one task.
+bool FNeuralNetworkPreProcessing::LinearColorsToTensor(TConstArrayView<FLinearColor> Pixels, const FNNEImageNormalization& Normalization, TArrayView<float> OutTensor)
+{
+    NEURALNETWORK_STAGE_SCOPE(STAT_NeuralNetwork_Normalize);
+
+    if (!FNormalizationKernel::IsValid(Normalization) || OutTensor.Num() < Pixels.Num() * Normalization.ColorChannels)
+    {
+        return false;
+    }
+
+    const int32 PixelCount = Pixels.Num();
+    const FNormalizationKernel Kernel(Normalization, PixelCount);
+    const int32 NumChunks = FMath::DivideAndRoundUp(PixelCount, NormalizeChunkSize);
+
+    ParallelFor(NumChunks, [&](int32 ChunkIdx)
+        {
+            const int32 Start = ChunkIdx * NormalizeChunkSize;
+            const int32 End = FMath::Min(Start + NormalizeChunkSize, PixelCount);
+
+            for (int32 PixelIdx = Start; PixelIdx < End; ++PixelIdx)
+            {
+                Kernel.Write(VectorLoad(&Pixels[PixelIdx].R), OutTensor.GetData(), PixelIdx);
+            }
+        }, FNeuralNetworkExecutor::IsExecutorThread() ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    return true;
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/Float16.h"
+
+#include "NeuralNetworkPreProcessing.generated.h"
+
+// Memory layout of an image input tensor
+UENUM(BlueprintType)
+enum class ENNETensorLayout : uint8
+{
+    NCHW,
+    NHWC
+};
+
+// Order the color channels are written in
+UENUM(BlueprintType)
+enum class ENNEChannelOrder : uint8
+{
+    RGB,
+    BGR
+};
+
+// Filter used when resizing captures to the model input size
+UENUM(BlueprintType)
+enum class ENNEResizeFilter : uint8
+{
+    // Two taps per axis, cheapest, aliases when shrinking a lot
+    Bilinear,
+    // Averages every source pixel covered by the output pixel, the right choice for heavy downscaling
+    Area
+};
+
+// How pixels are turned into model input values: Out = (Color * InputScale - Mean) / Std per channel
+USTRUCT(BlueprintType)
+struct AI_PLAYGROUND_API FNNEImageNormalization
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    ENNETensorLayout Layout = ENNETensorLayout::NCHW;
+
+    // 1 writes a single grayscale channel, 3 writes color channels
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing", meta = (ClampMin = "1", ClampMax = "3"))
+    int32 ColorChannels = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    ENNEChannelOrder ChannelOrder = ENNEChannelOrder::RGB;
+
+    // Decode 8-bit sRGB pixels to linear color, as FLinearColor(FColor) does
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    bool bSRGBToLinear = true;
+
+    // Multiplier applied to [0,1] colors before Mean and Std, e.g. 255 for models trained on byte values
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    float InputScale = 1.0f;
+
+    // Per channel mean in R, G, B order, the grayscale channel uses X
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    FVector3f Mean = FVector3f::ZeroVector;
+
+    // Per channel standard deviation in R, G, B order, the grayscale channel uses X
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    FVector3f Std = FVector3f::OneVector;
+
+    // R, G, B weights of the grayscale channel, the default matches the original Lerp based grayscale
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NNE Data PreProcessing")
+    FVector3f GrayscaleWeights = FVector3f(0.67f, 0.33f * 0.67f, 0.33f * 0.33f);
+};
+
+// Image preprocessing kernels that write straight into model input tensors
+struct AI_PLAYGROUND_API FNeuralNetworkPreProcessing
+{
+    // Reads layout, channels and image size from a rank 4 input shape, layout is NHWC when only the last dimension looks like channels
+    static bool DescribeImageShape(TConstArrayView<uint32> ShapeData, ENNETensorLayout& OutLayout, int32& OutColorChannels, int32& OutHeight, int32& OutWidth);
+
+    // Resizes an FColor image and writes it normalized into the tensor in a single pass over the source. Returns false on invalid sizes.
+    static bool PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<float> OutTensor);
+
+    // Half precision variant for fp16 inputs
+    static bool PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<FFloat16> OutTensor);
+
+    // Byte variant for quantized uint8 inputs, values are rounded and clamped to [0,255], so use InputScale 255 with bSRGBToLinear off for raw pixels
+    static bool PixelsToTensor(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, const FNNEImageNormalization& Normalization, TArrayView<uint8> OutTensor);
+
+    // Resizes an FColor image straight from its 8-bit channels into linear colors. Returns false on invalid sizes.
+    static bool ResizePixels(TConstArrayView<FColor> Pixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, ENNEResizeFilter Filter, bool bSRGBToLinear, TArrayView<FLinearColor> OutPixels);
+
+    // Normalizes an already resized linear color image into the tensor, in parallel chunks without locking. Returns false on invalid sizes.
+    static bool LinearColorsToTensor(TConstArrayView<FLinearColor> Pixels, const FNNEImageNormalization& Normalization, TArrayView<float> OutTensor);
+};
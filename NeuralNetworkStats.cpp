@@ -0,0 +1,116 @@
+#include "NeuralNetworkStats.h"
+
+
+DEFINE_LOG_CATEGORY(LogNeuralNetwork);
+DEFINE_LOG_CATEGORY(LogNeuralNetworkData);
+
+DEFINE_STAT(STAT_NeuralNetwork_Capture);
+DEFINE_STAT(STAT_NeuralNetwork_Resize);
+DEFINE_STAT(STAT_NeuralNetwork_Normalize);
+DEFINE_STAT(STAT_NeuralNetwork_PreProcess);
+DEFINE_STAT(STAT_NeuralNetwork_RunSync);
+DEFINE_STAT(STAT_NeuralNetwork_PostProcess);
+DEFINE_STAT(STAT_NeuralNetwork_Callback);
+DEFINE_STAT(STAT_NeuralNetwork_QueueWait);
+DEFINE_STAT(STAT_NeuralNetwork_InferencesCompleted);
+DEFINE_STAT(STAT_NeuralNetwork_RequestsQueued);
+DEFINE_STAT(STAT_NeuralNetwork_RequestsReplaced);
+DEFINE_STAT(STAT_NeuralNetwork_RequestsDropped);
+DEFINE_STAT(STAT_NeuralNetwork_CacheHits);
+DEFINE_STAT(STAT_NeuralNetwork_TemporalSkips);
+DEFINE_STAT(STAT_NeuralNetwork_ExecutorQueueDepth);
+DEFINE_STAT(STAT_NeuralNetwork_ExecutorUtilization);
+
+
+FNeuralNetworkLatencyTracker::FNeuralNetworkLatencyTracker(int32 InCapacity)
+    : Capacity(FMath::Max(1, InCapacity))
+{
+    Latencies.Reserve(Capacity);
+    CompletionTimes.Reserve(Capacity);
+}
+
+
+// Overwrites the oldest sample once the window is full.
+void FNeuralNetworkLatencyTracker::AddSample(double LatencySeconds)
+{
+    const double Now = FPlatformTime::Seconds();
+
+    FScopeLock Lock(&Mutex);
+
+    if (Latencies.Num() < Capacity)
+    {
+        Latencies.Add(LatencySeconds);
+        CompletionTimes.Add(Now);
+    }
+    else
+    {
+        Latencies[NextSample] = LatencySeconds;
+        CompletionTimes[NextSample] = Now;
+    }
+
+    NextSample = (NextSample + 1) % Capacity;
+    TotalSamples++;
+}
+
+
+// Sorts a copy of the window, only done when queried.
+void FNeuralNetworkLatencyTracker::GetPercentiles(float& OutP50Ms, float& OutP95Ms, float& OutP99Ms) const
+{
+    TArray<double> Sorted;
+    {
+        FScopeLock Lock(&Mutex);
+        Sorted = Latencies;
+    }
+
+    if (Sorted.Num() == 0)
+    {
+        OutP50Ms = OutP95Ms = OutP99Ms = 0.0f;
+        return;
+    }
+
+    Sorted.Sort();
+
+    auto Percentile = [&Sorted](double Fraction)
+        {
+            const int32 Idx = FMath::Clamp(FMath::CeilToInt32(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+            return static_cast<float>(Sorted[Idx] * 1000.0);
+        };
+
+    OutP50Ms = Percentile(0.50);
+    OutP95Ms = Percentile(0.95);
+    OutP99Ms = Percentile(0.99);
+}
+
+
+float FNeuralNetworkLatencyTracker::GetThroughput() const
+{
+    FScopeLock Lock(&Mutex);
+
+    if (CompletionTimes.Num() < 2)
+    {
+        return 0.0f;
+    }
+
+    // Oldest sample sits at NextSample once the window has wrapped
+    const double Oldest = CompletionTimes.Num() < Capacity ? CompletionTimes[0] : CompletionTimes[NextSample];
+    const double Window = FPlatformTime::Seconds() - Oldest;
+
+    return Window > 0.0 ? static_cast<float>(CompletionTimes.Num() / Window) : 0.0f;
+}
+
+
+int64 FNeuralNetworkLatencyTracker::GetTotalSamples() const
+{
+    FScopeLock Lock(&Mutex);
+    return TotalSamples;
+}
+
+
+void FNeuralNetworkLatencyTracker::Reset()
+{
+    FScopeLock Lock(&Mutex);
+    Latencies.Reset();
+    CompletionTimes.Reset();
+    NextSample = 0;
+    TotalSamples = 0;
+}
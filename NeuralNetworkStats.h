@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// General messages of the neural network pipeline
+AI_PLAYGROUND_API DECLARE_LOG_CATEGORY_EXTERN(LogNeuralNetwork, Log, All);
+
+// Per call traces and tensor dumps, VeryVerbose and off by default, compiled out of shipping builds
+#if UE_BUILD_SHIPPING
+AI_PLAYGROUND_API DECLARE_LOG_CATEGORY_EXTERN(LogNeuralNetworkData, Warning, Warning);
+#else
+AI_PLAYGROUND_API DECLARE_LOG_CATEGORY_EXTERN(LogNeuralNetworkData, Warning, All);
+#endif
+
+DECLARE_STATS_GROUP(TEXT("NeuralNetwork"), STATGROUP_NeuralNetwork, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Capture"), STAT_NeuralNetwork_Capture, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resize"), STAT_NeuralNetwork_Resize, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Normalize"), STAT_NeuralNetwork_Normalize, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PreProcess (fused)"), STAT_NeuralNetwork_PreProcess, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RunSync"), STAT_NeuralNetwork_RunSync, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PostProcess"), STAT_NeuralNetwork_PostProcess, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Callback"), STAT_NeuralNetwork_Callback, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Queue Wait (ms)"), STAT_NeuralNetwork_QueueWait, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Inferences Completed"), STAT_NeuralNetwork_InferencesCompleted, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests Queued"), STAT_NeuralNetwork_RequestsQueued, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests Replaced"), STAT_NeuralNetwork_RequestsReplaced, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests Dropped"), STAT_NeuralNetwork_RequestsDropped, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Result Cache Hits"), STAT_NeuralNetwork_CacheHits, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Temporal Skips"), STAT_NeuralNetwork_TemporalSkips, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Executor Queue Depth"), STAT_NeuralNetwork_ExecutorQueueDepth, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Executor Utilization (%)"), STAT_NeuralNetwork_ExecutorUtilization, STATGROUP_NeuralNetwork, AI_PLAYGROUND_API);
+
+// Cycle stat plus an Unreal Insights CPU scope for one pipeline stage
+#define NEURALNETWORK_STAGE_SCOPE(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+
+// Rolling window of latency samples, safe to add to from any thread
+class AI_PLAYGROUND_API FNeuralNetworkLatencyTracker
+{
+public:
+    explicit FNeuralNetworkLatencyTracker(int32 InCapacity = 1024);
+
+    // Records one finished request, latency in seconds
+    void AddSample(double LatencySeconds);
+
+    // Latency percentiles in milliseconds over the window, zero when empty
+    void GetPercentiles(float& OutP50Ms, float& OutP95Ms, float& OutP99Ms) const;
+
+    // Completed requests per second over the window
+    float GetThroughput() const;
+
+    int64 GetTotalSamples() const;
+
+    void Reset();
+
+private:
+    mutable FCriticalSection Mutex;
+
+    int32 Capacity;
+    int32 NextSample = 0;
+    int64 TotalSamples = 0;
+
+    TArray<double> Latencies;
+    TArray<double> CompletionTimes;
+};
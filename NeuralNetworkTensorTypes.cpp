@@ -0,0 +1,125 @@
+#include "NeuralNetworkTensorTypes.h"
+
+
+uint32 FNeuralNetworkTensorTypes::GetElementSize(ENNETensorDataType DataType)
+{
+    switch (DataType)
+    {
+    case ENNETensorDataType::Char:
+    case ENNETensorDataType::Boolean:
+    case ENNETensorDataType::Int8:
+    case ENNETensorDataType::UInt8:
+        return 1;
+    case ENNETensorDataType::Half:
+    case ENNETensorDataType::BFloat16:
+    case ENNETensorDataType::Int16:
+    case ENNETensorDataType::UInt16:
+        return 2;
+    case ENNETensorDataType::Float:
+    case ENNETensorDataType::Int32:
+    case ENNETensorDataType::UInt32:
+        return 4;
+    case ENNETensorDataType::Double:
+    case ENNETensorDataType::Int64:
+    case ENNETensorDataType::UInt64:
+    case ENNETensorDataType::Complex64:
+        return 8;
+    case ENNETensorDataType::Complex128:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+
+bool FNeuralNetworkTensorTypes::IsConvertible(ENNETensorDataType DataType)
+{
+    return DataType == ENNETensorDataType::Float || DataType == ENNETensorDataType::Half
+        || DataType == ENNETensorDataType::Int8 || DataType == ENNETensorDataType::UInt8;
+}
+
+
+bool FNeuralNetworkTensorTypes::FromFloat(TConstArrayView<float> Values, ENNETensorDataType DataType, void* Dst)
+{
+    const int32 Num = Values.Num();
+    const float* Src = Values.GetData();
+
+    switch (DataType)
+    {
+    case ENNETensorDataType::Float:
+        FMemory::Memcpy(Dst, Src, Num * sizeof(float));
+        return true;
+    case ENNETensorDataType::Half:
+    {
+        FFloat16* Out = static_cast<FFloat16*>(Dst);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = FFloat16(Src[Idx]);
+        }
+        return true;
+    }
+    case ENNETensorDataType::Int8:
+    {
+        int8* Out = static_cast<int8*>(Dst);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = static_cast<int8>(FMath::Clamp(FMath::RoundToInt32(Src[Idx]), -128, 127));
+        }
+        return true;
+    }
+    case ENNETensorDataType::UInt8:
+    {
+        uint8* Out = static_cast<uint8*>(Dst);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(Src[Idx]), 0, 255));
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+
+bool FNeuralNetworkTensorTypes::ToFloat(const void* Src, ENNETensorDataType DataType, TArrayView<float> OutValues)
+{
+    const int32 Num = OutValues.Num();
+    float* Out = OutValues.GetData();
+
+    switch (DataType)
+    {
+    case ENNETensorDataType::Float:
+        FMemory::Memcpy(Out, Src, Num * sizeof(float));
+        return true;
+    case ENNETensorDataType::Half:
+    {
+        const FFloat16* In = static_cast<const FFloat16*>(Src);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = In[Idx].GetFloat();
+        }
+        return true;
+    }
+    case ENNETensorDataType::Int8:
+    {
+        const int8* In = static_cast<const int8*>(Src);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = In[Idx];
+        }
+        return true;
+    }
+    case ENNETensorDataType::UInt8:
+    {
+        const uint8* In = static_cast<const uint8*>(Src);
+        for (int32 Idx = 0; Idx < Num; ++Idx)
+        {
+            Out[Idx] = In[Idx];
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
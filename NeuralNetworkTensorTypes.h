@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/Float16.h"
+#include "NNETypes.h"
+
+// Element type helpers for bindings whose storage follows the model's tensor descs instead of always being float
+struct AI_PLAYGROUND_API FNeuralNetworkTensorTypes
+{
+    // Bytes per element, 0 for types the bindings cannot store
+    static uint32 GetElementSize(ENNETensorDataType DataType);
+
+    // Float, Half, Int8 and UInt8 can be converted from and to float
+    static bool IsConvertible(ENNETensorDataType DataType);
+
+    // Writes Values into Num elements of DataType at Dst, integer types are rounded and clamped to their range
+    static bool FromFloat(TConstArrayView<float> Values, ENNETensorDataType DataType, void* Dst);
+
+    // Widens Num elements of DataType at Src into OutValues
+    static bool ToFloat(const void* Src, ENNETensorDataType DataType, TArrayView<float> OutValues);
+};